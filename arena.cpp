@@ -0,0 +1,22 @@
+#include "arena.hpp"
+#include <algorithm>
+
+ScratchArena::ScratchArena(std::size_t initialSize) : buffer(initialSize) {
+    monotonic.emplace(buffer.data(), buffer.size(), std::pmr::new_delete_resource());
+}
+
+void ScratchArena::reset() {
+    monotonic.reset();
+    // Alignment padding is not counted in `usage`, so grow with some headroom for the next test.
+    if (buffer.size() < peakUsage) {
+        buffer = std::vector<std::byte>(peakUsage + peakUsage / 8);
+    }
+    monotonic.emplace(buffer.data(), buffer.size(), std::pmr::new_delete_resource());
+    usage = 0;
+}
+
+void *ScratchArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    usage += bytes;
+    peakUsage = std::max(peakUsage, usage);
+    return monotonic->allocate(bytes, alignment);
+}
@@ -0,0 +1,63 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Monotonic memory resource for generator scratch memory that is reused between tests.
+ *
+ * Deallocation is a no-op, everything is released at once by `reset()`. After a reset the arena owns a single buffer
+ * as large as the biggest usage seen so far, so a suite that generates many similar tests stops allocating from the
+ * heap after the first one.
+ *
+ * @code
+ * ScratchArena arena;
+ * for (std::uint64_t test = 1; test <= 300; ++test) {
+ *     arena.reset();
+ *     Graph g = Graph::constructForestGraph(100000, 10, &arena);
+ *     ...
+ * }
+ * @endcode
+ */
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    explicit ScratchArena(std::size_t initialSize = 1 << 16);
+
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    // Releases all scratch memory and grows the owned buffer to the peak usage if needed.
+    void reset();
+
+    // bytes handed out since the last reset
+    std::size_t getUsage() const {
+        return usage;
+    }
+
+    // largest `getUsage()` ever observed
+    std::size_t getPeakUsage() const {
+        return peakUsage;
+    }
+
+    // size of the buffer that serves allocations without touching the heap
+    std::size_t getCapacity() const {
+        return buffer.size();
+    }
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    std::vector<std::byte> buffer;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+    std::size_t usage = 0;
+    std::size_t peakUsage = 0;
+};
+
+#endif
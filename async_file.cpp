@@ -0,0 +1,201 @@
+#include "async_file.hpp"
+#include "instrument.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+// alignment of O_DIRECT buffers, offsets and sizes; 4096 covers the logical block size of every common device
+constexpr std::size_t directAlignment = 4096;
+
+[[noreturn]] void fail(const std::filesystem::path &path, const char *action) {
+    std::cerr << "Error: Could not " << action << " the file " << path.string() << ": " << std::strerror(errno)
+              << std::endl;
+    exit(1);
+}
+
+}  // namespace
+
+AsyncFileBuffer::AsyncFileBuffer(const std::filesystem::path &path, const AsyncFileOptions &options)
+    : path(path),
+      bufferSize((std::max<std::size_t>(options.bufferSize, 1) + directAlignment - 1) / directAlignment *
+                 directAlignment) {
+    // The buffers come first, so a failed allocation does not leave the file open.
+    for (auto &buffer : buffers) {
+        buffer.reset(static_cast<char *>(std::aligned_alloc(directAlignment, bufferSize)));
+        if (!buffer) {
+            throw std::bad_alloc();
+        }
+    }
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef __linux__
+    if (options.directIo) {
+        fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+        direct = fd >= 0;
+    }
+#endif
+    if (fd < 0) {
+        fd = ::open(path.c_str(), flags, 0644);
+    }
+    if (fd < 0) {
+        fail(path, "open");
+    }
+    // Only a hint, file systems without fallocate simply allocate as the data arrives.
+    if (options.preallocate > 0) {
+#ifdef __linux__
+        [[maybe_unused]] int result =
+            ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(options.preallocate));
+#elif defined(_POSIX_ADVISORY_INFO) && _POSIX_ADVISORY_INFO > 0
+        // posix_fallocate extends the file, `finish` truncates it to the written size
+        preallocated = ::posix_fallocate(fd, 0, static_cast<off_t>(options.preallocate)) == 0;
+#endif
+    }
+    setp(buffers[0].get(), buffers[0].get() + bufferSize);
+    writer = std::thread([this] { writeLoop(); });
+}
+
+AsyncFileBuffer::~AsyncFileBuffer() {
+    finish();
+}
+
+void AsyncFileBuffer::finish() {
+    if (finished) {
+        return;
+    }
+    finished = true;
+    waitUntilIdle();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    writer.join();
+
+    const std::size_t tail = pptr() - pbase();
+#ifdef __linux__
+    // The tail is not a whole aligned block, so it bypasses O_DIRECT.
+    if (direct && tail > 0 && ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT) != 0) {
+        fail(path, "write");
+    }
+#endif
+    writeAt(pbase(), tail, submittedBytes);
+    submittedBytes += tail;
+    setp(nullptr, nullptr);
+    if (preallocated && ::ftruncate(fd, static_cast<off_t>(submittedBytes)) != 0) {
+        fail(path, "write");
+    }
+    if (::close(fd) != 0) {
+        fail(path, "close");
+    }
+}
+
+void AsyncFileBuffer::submit() {
+    TESTFRAME_SCOPED_TIMER("AsyncFileBuffer::submit");
+    const std::size_t size = pptr() - pbase();
+    if (size == 0) {
+        return;
+    }
+    // The writer may still hold the other buffer, which is about to be reused.
+    waitUntilIdle();
+    {
+        std::lock_guard lock(mutex);
+        pendingData = pbase();
+        pendingSize = size;
+        pendingOffset = submittedBytes;
+    }
+    changed.notify_all();
+    submittedBytes += size;
+    current ^= 1;
+    setp(buffers[current].get(), buffers[current].get() + bufferSize);
+}
+
+void AsyncFileBuffer::waitUntilIdle() {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [this] { return pendingSize == 0; });
+}
+
+void AsyncFileBuffer::writeLoop() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        changed.wait(lock, [this] { return pendingSize > 0 || stopping; });
+        if (pendingSize == 0) {
+            return;
+        }
+        const char *data = pendingData;
+        std::size_t size = pendingSize;
+        std::uint64_t offset = pendingOffset;
+        lock.unlock();
+        writeAt(data, size, offset);
+        lock.lock();
+        pendingSize = 0;
+        changed.notify_all();
+    }
+}
+
+void AsyncFileBuffer::writeAt(const char *data, std::size_t size, std::uint64_t offset) {
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fail(path, "write");
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+}
+
+AsyncFileBuffer::int_type AsyncFileBuffer::overflow(int_type ch) {
+    assert(!finished);
+    submit();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize AsyncFileBuffer::xsputn(const char *data, std::streamsize size) {
+    std::streamsize written = 0;
+    while (written < size) {
+        if (pptr() == epptr()) {
+            submit();
+        }
+        std::streamsize chunk = std::min<std::streamsize>(size - written, epptr() - pptr());
+        std::memcpy(pptr(), data + written, static_cast<std::size_t>(chunk));
+        pbump(static_cast<int>(chunk));
+        written += chunk;
+    }
+    return written;
+}
+
+AsyncFileBuffer::pos_type AsyncFileBuffer::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                   std::ios_base::openmode which) {
+    if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::out)) {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(static_cast<off_type>(submittedBytes + (pptr() - pbase())));
+}
+
+AsyncOutputFile::AsyncOutputFile(const std::filesystem::path &path, const AsyncFileOptions &options)
+    : std::ostream(nullptr),
+      buffer(std::make_unique<AsyncFileBuffer>(path, options)) {
+    rdbuf(buffer.get());
+}
+
+AsyncOutputFile::~AsyncOutputFile() {
+    close();
+}
+
+void AsyncOutputFile::close() {
+    if (buffer) {
+        buffer->finish();
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef ASYNC_FILE_H_
+#define ASYNC_FILE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+
+struct AsyncFileOptions {
+    // size of each of the two buffers, rounded up to a multiple of 4096
+    std::size_t bufferSize = 4 << 20;
+    // bypass the page cache with O_DIRECT on Linux, silently falls back to buffered writes where it is not supported
+    bool directIo = false;
+    // expected file size, reserved up front with fallocate (posix_fallocate off Linux) so the file system can lay out
+    // the file in one go
+    std::uint64_t preallocate = 0;
+};
+
+/**
+ * @brief Output buffer writing a file with double buffering: the caller formats into one buffer while a background
+ * thread writes the other one with `pwrite`, so generation and disk I/O overlap.
+ *
+ * Full buffers are written at offsets that are multiples of the (aligned) buffer size, which O_DIRECT requires; only
+ * the last, partial buffer is written through the page cache. `sync` does not write anything early, the file is
+ * complete after `finish` or destruction. I/O errors are reported on `std::cerr` and end the program.
+ */
+class AsyncFileBuffer : public std::streambuf {
+public:
+    explicit AsyncFileBuffer(const std::filesystem::path &path, const AsyncFileOptions &options = {});
+    ~AsyncFileBuffer() override;
+
+    AsyncFileBuffer(const AsyncFileBuffer &) = delete;
+    AsyncFileBuffer &operator=(const AsyncFileBuffer &) = delete;
+
+    // Writes the remaining text and closes the file; nothing may be written afterwards.
+    void finish();
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *data, std::streamsize size) override;
+    // Only reports the position, the number of bytes written so far, e.g. for `tellp`.
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+private:
+    using Buffer = std::unique_ptr<char, decltype(&std::free)>;
+
+    // Hands the current buffer to the writer thread and continues in the other one.
+    void submit();
+    void waitUntilIdle();
+    void writeLoop();
+    void writeAt(const char *data, std::size_t size, std::uint64_t offset);
+
+    std::filesystem::path path;
+    int fd = -1;
+    bool direct = false;
+    // posix_fallocate grew the file, `finish` cuts it back to the written size
+    bool preallocated = false;
+    std::size_t bufferSize;
+    Buffer buffers[2] = {Buffer(nullptr, std::free), Buffer(nullptr, std::free)};
+    unsigned current = 0;
+    std::uint64_t submittedBytes = 0;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    // the buffer handed to the writer thread, `pendingSize` == 0 when it is idle
+    const char *pendingData = nullptr;
+    std::size_t pendingSize = 0;
+    std::uint64_t pendingOffset = 0;
+    bool stopping = false;
+    std::thread writer;
+    bool finished = false;
+};
+
+// File written through an `AsyncFileBuffer`, complete once closed or destroyed.
+class AsyncOutputFile : public std::ostream {
+public:
+    explicit AsyncOutputFile(const std::filesystem::path &path, const AsyncFileOptions &options = {});
+    ~AsyncOutputFile() override;
+
+    void close();
+
+private:
+    std::unique_ptr<AsyncFileBuffer> buffer;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef BENCH_UTILS_H_
+#define BENCH_UTILS_H_
+
+#include <benchmark/benchmark.h>
+#include <sys/resource.h>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+
+// Stream buffer that only counts the characters written to it, so printers are measured without I/O.
+class CountingBuffer : public std::streambuf {
+public:
+    std::uint64_t count = 0;
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            ++count;
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char *, std::streamsize n) override {
+        count += n;
+        return n;
+    }
+};
+
+// Peak resident set size of the whole process so far, in kilobytes.
+inline double peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss);
+}
+
+// Reports node and edge throughput together with the peak RSS.
+inline void reportGraphThroughput(benchmark::State &state, std::uint64_t nodes, std::uint64_t edges) {
+    state.counters["nodes/s"] = benchmark::Counter(static_cast<double>(nodes * state.iterations()),
+                                                   benchmark::Counter::kIsRate);
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(edges * state.iterations()),
+                                                   benchmark::Counter::kIsRate);
+    state.counters["peak_rss_kb"] = peakRssKb();
+}
+
+#endif
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+"""Compares two google-benchmark JSON reports and fails on slowdowns above a threshold."""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        report = json.load(f)
+    return {b["name"]: b for b in report["benchmarks"] if b.get("run_type", "iteration") == "iteration"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent")
+    args = parser.parse_args()
+
+    baseline, current = load(args.baseline), load(args.current)
+    regressions = 0
+    for name, bench in current.items():
+        if name not in baseline:
+            print(f"{name:60} new")
+            continue
+        before, after = baseline[name]["cpu_time"], bench["cpu_time"]
+        change = (after - before) / before * 100.0 if before else 0.0
+        marker = ""
+        if change > args.threshold:
+            marker = "  <-- REGRESSION"
+            regressions += 1
+        print(f"{name:60} {before:14.1f} {after:14.1f} {change:+8.1f}%{marker}")
+    for name in baseline.keys() - current.keys():
+        print(f"{name:60} removed")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) slower than the {args.threshold}% threshold")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,192 @@
+#include "bench_utils.hpp"
+#include "dynamic_graph.hpp"
+#include "graph.hpp"
+#include "rand.hpp"
+#include "tree.hpp"
+#include "weighted_graph.hpp"
+#include "worst_case.hpp"
+
+namespace {
+
+template <typename Generator>
+void runGenerator(benchmark::State &state, Generator generate) {
+    std::uint64_t nodes = state.range(0);
+    std::uint64_t edges = 0;
+    rnd.setSeed(137);
+    for (auto _ : state) {
+        Graph g = generate(nodes);
+        edges = g.getNumberOfEdges();
+        benchmark::DoNotOptimize(g.graph.data());
+    }
+    reportGraphThroughput(state, nodes, edges);
+}
+
+void BM_UndirectedClique(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructUndirectedClique(n); });
+}
+BENCHMARK(BM_UndirectedClique)->RangeMultiplier(4)->Range(64, 1024);
+
+void BM_PathGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructPathGraph(n, 10); });
+}
+BENCHMARK(BM_PathGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_ShallowForestGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructShallowForestGraph(n, 10); });
+}
+BENCHMARK(BM_ShallowForestGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_ForestGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructForestGraph(n, 10); });
+}
+BENCHMARK(BM_ForestGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_SimplerJellyfishGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructSimplerJellyfishGraph(n, n / 4, 1, 16); });
+}
+BENCHMARK(BM_SimplerJellyfishGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_StarfishGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructStarfishGraph(n, 1, 16); });
+}
+BENCHMARK(BM_StarfishGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_SilkwormGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructSilkwormGraph(n); });
+}
+BENCHMARK(BM_SilkwormGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_TreeOfBoundedDegreeGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructTreeOfBoundedDegreeGraph(n, 1, 4); });
+}
+BENCHMARK(BM_TreeOfBoundedDegreeGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_BoundedDegreeTreeToCsr(benchmark::State &state) {
+    std::uint64_t nodes = state.range(0);
+    rnd.setSeed(137);
+    for (auto _ : state) {
+        CsrGraph g = Tree::constructBoundedDegreeTree(nodes, 3).toCsr();
+        benchmark::DoNotOptimize(g.targets.data());
+    }
+    reportGraphThroughput(state, nodes, 2 * (nodes - 1));
+}
+BENCHMARK(BM_BoundedDegreeTreeToCsr)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_SparseGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructSparseGraph(n); });
+}
+BENCHMARK(BM_SparseGraph)->RangeMultiplier(4)->Range(64, 1024);
+
+void BM_DenseGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructDenseGraph(n); });
+}
+BENCHMARK(BM_DenseGraph)->RangeMultiplier(4)->Range(64, 1024);
+
+void BM_RandomDAG(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructRandomDAG(n, 4 * n, 16); });
+}
+BENCHMARK(BM_RandomDAG)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_RegularGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructRegularGraph(n, 4); });
+}
+BENCHMARK(BM_RegularGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_BipartiteGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructBipartiteGraph(n / 2, n / 2, 8. / n); });
+}
+BENCHMARK(BM_BipartiteGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_GridGraph(benchmark::State &state) {
+    runGenerator(state, [](std::uint64_t n) { return Graph::constructGridGraph(n / 256, 256); });
+}
+BENCHMARK(BM_GridGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_DirectedGraph(benchmark::State &state) {
+    Graph tree = Graph::constructTreeGraph(state.range(0));
+    runGenerator(state, [&tree](std::uint64_t) { return Graph::constructDirectedGraph(tree); });
+}
+BENCHMARK(BM_DirectedGraph)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_AddRandomWeights(benchmark::State &state) {
+    std::uint64_t nodes = state.range(0);
+    Graph tree = Graph::constructTreeGraph(nodes);
+    for (auto _ : state) {
+        WeightedGraph w = WeightedGraph::addRandomWeights(tree, 1, 1000000);
+        benchmark::DoNotOptimize(w.graph.data());
+    }
+    reportGraphThroughput(state, nodes, tree.getNumberOfEdges());
+}
+BENCHMARK(BM_AddRandomWeights)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_RelabelNodes(benchmark::State &state) {
+    std::uint64_t nodes = state.range(0);
+    Graph g = Graph::constructTreeGraph(nodes);
+    for (auto _ : state) {
+        g.relabelNodes();
+        benchmark::DoNotOptimize(g.graph.data());
+    }
+    reportGraphThroughput(state, nodes, g.getNumberOfEdges());
+}
+BENCHMARK(BM_RelabelNodes)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_Normalize(benchmark::State &state) {
+    std::uint64_t nodes = state.range(0);
+    rnd.setSeed(137);
+    Graph dense = Graph::constructDirectedGraph(Graph::constructDenseGraph(nodes));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Graph g = dense;
+        state.ResumeTiming();
+        g.normalize(true);
+        benchmark::DoNotOptimize(g.graph.data());
+    }
+    reportGraphThroughput(state, nodes, dense.getNumberOfEdges());
+}
+BENCHMARK(BM_Normalize)->RangeMultiplier(4)->Range(64, 1024);
+
+void BM_EdgeUnion(benchmark::State &state) {
+    std::uint64_t nodes = state.range(0);
+    rnd.setSeed(137);
+    Graph a = Graph::constructDenseGraph(nodes).normalize();
+    Graph b = Graph::constructDenseGraph(nodes).normalize();
+    for (auto _ : state) {
+        Graph g = Graph::edgeUnion(a, b);
+        benchmark::DoNotOptimize(g.graph.data());
+    }
+    reportGraphThroughput(state, nodes, a.getNumberOfEdges() + b.getNumberOfEdges());
+}
+BENCHMARK(BM_EdgeUnion)->RangeMultiplier(4)->Range(64, 1024);
+
+void BM_DynamicGraphEdits(benchmark::State &state) {
+    std::uint64_t nodes = state.range(0);
+    rnd.setSeed(137);
+    DynamicGraph g(Graph::constructRegularGraph(nodes, 4));
+    for (auto _ : state) {
+        // one random edge out, one new random edge in, so the size stays the same
+        auto [from, to] = g.randomEdge();
+        g.removeEdge(from, to);
+        while (!g.addEdge(rnd.intFromRange(nodes - 1), rnd.intFromRange(nodes - 1))) {
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(2 * state.iterations()));
+}
+BENCHMARK(BM_DynamicGraphEdits)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+void BM_AnnealingDfsDepth(benchmark::State &state) {
+    std::uint64_t nodes = state.range(0);
+    rnd.setSeed(137);
+    DynamicGraph initial(Graph::constructRegularGraph(nodes, 3));
+    SearchOptions options;
+    options.evaluations = 1024;
+    options.threads = 0;
+    for (auto _ : state) {
+        auto result = annealingSearch(initial, [](DynamicGraph &g) { moveRandomEdge(g); },
+                                      [](const DynamicGraph &g) { return double(dfsRecursionDepth(g, 0)); }, options);
+        benchmark::DoNotOptimize(result.score);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(options.evaluations * state.iterations()));
+}
+BENCHMARK(BM_AnnealingDfsDepth)->RangeMultiplier(4)->Range(1 << 8, 1 << 12)->UseRealTime();
+
+}  // namespace
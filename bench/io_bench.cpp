@@ -0,0 +1,287 @@
+#include "bench_utils.hpp"
+#include "async_file.hpp"
+#include "checker.hpp"
+#include "edge_stream.hpp"
+#include "format.hpp"
+#include "graph.hpp"
+#include "matrix.hpp"
+#include "rand.hpp"
+#include "weighted_graph.hpp"
+#ifdef TESTFRAME_COMPRESSION
+#include "compressed_stream.hpp"
+#endif
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+template <typename Printable, typename Format>
+void runPrinter(benchmark::State &state, const Printable &printable, Format format) {
+    CountingBuffer buffer;
+    std::ostream out(&buffer);
+    for (auto _ : state) {
+        printable.printTo(out, format);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(buffer.count));
+    state.counters["peak_rss_kb"] = peakRssKb();
+}
+
+void BM_GraphPrint(benchmark::State &state) {
+    Graph g = Graph::constructTreeGraph(state.range(0));
+    runPrinter(state, g, static_cast<Graph::PrintFormat>(state.range(1)));
+}
+BENCHMARK(BM_GraphPrint)
+    ->ArgNames({"nodes", "format"})
+    ->ArgsProduct({{1 << 12, 1 << 18}, {0, 1, 2, 3}});
+
+void BM_ParallelGraphPrint(benchmark::State &state) {
+    Graph g = Graph::constructTreeGraph(1 << 20);
+    CountingBuffer buffer;
+    std::ostream out(&buffer);
+    for (auto _ : state) {
+        g.printTo(out, Graph::PrintFormat::SolutionAdjecencyList, static_cast<unsigned>(state.range(0)));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(buffer.count));
+}
+BENCHMARK(BM_ParallelGraphPrint)->ArgName("threads")->Arg(1)->Arg(4)->UseRealTime();
+
+void BM_WeightedGraphPrint(benchmark::State &state) {
+    WeightedGraph g = WeightedGraph::addRandomWeights(Graph::constructTreeGraph(state.range(0)), -1000000, 1000000);
+    runPrinter(state, g, static_cast<WeightedGraph::PrintFormat>(state.range(1)));
+}
+// The matrix formats are quadratic, so they only get the small size.
+BENCHMARK(BM_WeightedGraphPrint)
+    ->ArgNames({"nodes", "format"})
+    ->ArgsProduct({{1 << 12}, {0, 1, 2, 3}})
+    ->Args({1 << 18, 0})
+    ->Args({1 << 18, 1});
+
+void BM_MatrixPrint(benchmark::State &state) {
+    std::uint64_t size = state.range(0);
+    Matrix<std::int64_t> m(size, size);
+    for (auto &row : m.matrix) {
+        for (auto &x : row) {
+            x = rnd.intFromRange(-1000000000, 1000000000);
+        }
+    }
+    runPrinter(state, m, static_cast<MatrixPrintFormat>(state.range(1)));
+}
+BENCHMARK(BM_MatrixPrint)->ArgNames({"size", "format"})->ArgsProduct({{64, 1024}, {0, 1}});
+
+void BM_ReadGraph(benchmark::State &state) {
+    Graph g = Graph::constructTreeGraph(state.range(0));
+    std::ostringstream out;
+    g.printTo(out, Graph::PrintFormat::SolutionAdjecencyList);
+    const std::string text = out.str();
+    for (auto _ : state) {
+        std::istringstream in(text);
+        Graph read = Graph::readGraph(in);
+        benchmark::DoNotOptimize(read.graph.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(text.size() * state.iterations()));
+    reportGraphThroughput(state, g.getNumberOfNodes(), g.getNumberOfEdges());
+}
+BENCHMARK(BM_ReadGraph)->RangeMultiplier(8)->Range(1 << 12, 1 << 18);
+
+void BM_ReadWeightedGraph(benchmark::State &state) {
+    WeightedGraph g = WeightedGraph::addRandomWeights(Graph::constructTreeGraph(state.range(0)), -1000000, 1000000);
+    std::ostringstream out;
+    g.printTo(out, WeightedGraph::PrintFormat::SolutionAdjecencyList);
+    const std::string text = out.str();
+    for (auto _ : state) {
+        std::istringstream in(text);
+        WeightedGraph read = WeightedGraph::readWeightedGraph(in);
+        benchmark::DoNotOptimize(read.graph.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(text.size() * state.iterations()));
+    reportGraphThroughput(state, g.getNumberOfNodes(), g.getNumberOfEdges());
+}
+BENCHMARK(BM_ReadWeightedGraph)->RangeMultiplier(8)->Range(1 << 12, 1 << 18);
+
+void BM_ReadMatrix(benchmark::State &state) {
+    std::uint64_t size = state.range(0);
+    Matrix<std::int64_t> m(size, size);
+    std::ostringstream out;
+    m.printTo(out, MatrixPrintFormat::Solution);
+    const std::string text = out.str();
+    for (auto _ : state) {
+        std::istringstream in(text);
+        auto read = Matrix<std::int64_t>::readMatrix(in);
+        benchmark::DoNotOptimize(read.matrix.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(text.size() * state.iterations()));
+}
+BENCHMARK(BM_ReadMatrix)->Arg(64)->Arg(1024);
+
+// Judging a printed graph against itself, with the token comparator and with a std::istream loop.
+std::string printedGraph() {
+    std::ostringstream out;
+    Graph::constructTreeGraph(1 << 18).printTo(out, Graph::PrintFormat::SolutionAdjecencyList);
+    return out.str();
+}
+
+void BM_CompareTokens(benchmark::State &state) {
+    const std::string text = printedGraph();
+    for (auto _ : state) {
+        TokenReader expected(text), actual(text);
+        benchmark::DoNotOptimize(compareTokens(expected, actual, state.range(0) == 0 ? 0 : 1e-9).accepted);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(2 * text.size() * state.iterations()));
+}
+BENCHMARK(BM_CompareTokens)->ArgName("epsilon")->Arg(0)->Arg(1);
+
+void BM_CompareIstream(benchmark::State &state) {
+    const std::string text = printedGraph();
+    for (auto _ : state) {
+        std::istringstream expected(text), actual(text);
+        std::string a, b;
+        bool equal = true;
+        while (expected >> a && actual >> b) {
+            equal &= a == b;
+        }
+        benchmark::DoNotOptimize(equal);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(2 * text.size() * state.iterations()));
+}
+BENCHMARK(BM_CompareIstream);
+
+// Integer formatting kernels on values of every length: the digit-pair kernel of `format.hpp`, `std::to_chars` and
+// `std::ostream`.
+std::vector<std::int64_t> formattingInput() {
+    std::vector<std::int64_t> values(1 << 16);
+    rnd.setSeed(137);
+    for (auto &value : values) {
+        value = rnd.intFromRange(-1000000000000000000, 1000000000000000000) >> rnd.intFromRange(0, 60);
+    }
+    return values;
+}
+
+void BM_FormatDigitPairs(benchmark::State &state) {
+    const auto values = formattingInput();
+    std::vector<char> text(values.size() * 21);
+    std::uint64_t bytes = 0;
+    for (auto _ : state) {
+        char *position = text.data();
+        for (auto value : values) {
+            position = format::formatSigned(position, value);
+        }
+        bytes += position - text.data();
+        benchmark::DoNotOptimize(text.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.SetItemsProcessed(static_cast<std::int64_t>(values.size() * state.iterations()));
+}
+BENCHMARK(BM_FormatDigitPairs);
+
+void BM_FormatToChars(benchmark::State &state) {
+    const auto values = formattingInput();
+    std::vector<char> text(values.size() * 21);
+    std::uint64_t bytes = 0;
+    for (auto _ : state) {
+        char *position = text.data();
+        for (auto value : values) {
+            position = std::to_chars(position, position + 21, value).ptr;
+        }
+        bytes += position - text.data();
+        benchmark::DoNotOptimize(text.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.SetItemsProcessed(static_cast<std::int64_t>(values.size() * state.iterations()));
+}
+BENCHMARK(BM_FormatToChars);
+
+void BM_FormatOstream(benchmark::State &state) {
+    const auto values = formattingInput();
+    CountingBuffer buffer;
+    std::ostream out(&buffer);
+    for (auto _ : state) {
+        for (auto value : values) {
+            out << value << ' ';
+        }
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(buffer.count));
+    state.SetItemsProcessed(static_cast<std::int64_t>(values.size() * state.iterations()));
+}
+BENCHMARK(BM_FormatOstream);
+
+// Printing into a real file, format 0 is std::ofstream, 1 the double-buffered writer and 2 the same with O_DIRECT.
+void BM_FilePrint(benchmark::State &state) {
+    Graph g = Graph::constructTreeGraph(1 << 18);
+    const auto path = std::filesystem::temp_directory_path() / "testframe_bench_file_print.in";
+    std::uint64_t bytes = 0;
+    for (auto _ : state) {
+        std::unique_ptr<std::ostream> out;
+        if (state.range(0) == 0) {
+            out = std::make_unique<std::ofstream>(path);
+        } else {
+            out = std::make_unique<AsyncOutputFile>(path, AsyncFileOptions{.directIo = state.range(0) == 2});
+        }
+        g.printTo(*out, Graph::PrintFormat::SolutionAdjecencyList);
+        bytes += static_cast<std::uint64_t>(out->tellp());
+    }
+    std::filesystem::remove(path);
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+}
+BENCHMARK(BM_FilePrint)->ArgName("writer")->DenseRange(0, 2)->UseRealTime();
+
+// Adjacency-ordered output of a relabeled stream, the budget forces runs of 2^20 edges onto the disk.
+void BM_SortedEdgeStreamWrite(benchmark::State &state) {
+    const ExternalSortOptions options{.memoryBudget = static_cast<std::size_t>(state.range(0)) << 20};
+    CountingBuffer buffer;
+    std::ostream out(&buffer);
+    std::uint64_t edges = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        rnd.setSeed(137);
+        EdgeStream stream = EdgeStream::constructRandomDAG(1 << 20, 1 << 23, 64);
+        state.ResumeTiming();
+        stream.writeSortedTo(out, false, options);
+        edges += stream.getNumberOfEdges();
+    }
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(edges), benchmark::Counter::kIsRate);
+    state.SetBytesProcessed(static_cast<std::int64_t>(buffer.count));
+}
+BENCHMARK(BM_SortedEdgeStreamWrite)->ArgName("budget_mib")->Arg(16)->Arg(1024)->UseRealTime();
+
+#ifdef TESTFRAME_COMPRESSION
+// Bytes processed count the uncompressed text, `compressed_bytes` what reaches the disk.
+void BM_GzipGraphPrint(benchmark::State &state) {
+    Graph g = Graph::constructTreeGraph(1 << 18);
+    CountingBuffer sink;
+    std::ostream sinkStream(&sink);
+    std::uint64_t text = 0;
+    for (auto _ : state) {
+        GzipOutputBuffer buffer(sinkStream, static_cast<int>(state.range(0)), static_cast<unsigned>(state.range(1)));
+        std::ostream out(&buffer);
+        g.printTo(out, Graph::PrintFormat::SolutionAdjecencyList);
+        text += static_cast<std::uint64_t>(out.tellp());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(text));
+    state.counters["compressed_bytes"] = static_cast<double>(sink.count) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_GzipGraphPrint)->ArgNames({"level", "threads"})->ArgsProduct({{1, 6}, {1, 4}});
+
+void BM_GzipReadGraph(benchmark::State &state) {
+    Graph g = Graph::constructTreeGraph(1 << 18);
+    std::ostringstream compressed;
+    {
+        GzipOutputBuffer buffer(compressed);
+        std::ostream out(&buffer);
+        g.printTo(out, Graph::PrintFormat::SolutionAdjecencyList);
+    }
+    const std::string data = compressed.str();
+    for (auto _ : state) {
+        std::istringstream source(data);
+        GzipInputBuffer buffer(source);
+        std::istream in(&buffer);
+        Graph read = Graph::readGraph(in);
+        benchmark::DoNotOptimize(read.graph.data());
+    }
+    reportGraphThroughput(state, g.getNumberOfNodes(), g.getNumberOfEdges());
+}
+BENCHMARK(BM_GzipReadGraph);
+#endif
+
+}  // namespace
@@ -0,0 +1,92 @@
+#include "bench_utils.hpp"
+#include "matrix.hpp"
+#include "rand.hpp"
+
+namespace {
+
+Matrix<std::int64_t> randomMatrix(std::uint64_t size) {
+    Matrix<std::int64_t> m(size, size);
+    for (auto &row : m.matrix) {
+        for (auto &x : row) {
+            x = rnd.intFromRange(-1000, 1000);
+        }
+    }
+    return m;
+}
+
+void reportCells(benchmark::State &state, std::uint64_t cells) {
+    state.counters["cells/s"] = benchmark::Counter(static_cast<double>(cells * state.iterations()),
+                                                   benchmark::Counter::kIsRate);
+}
+
+void BM_MatrixAdd(benchmark::State &state) {
+    auto a = randomMatrix(state.range(0)), b = randomMatrix(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((a + b).matrix.data());
+    }
+    reportCells(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_MatrixAdd)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_MatrixSubtract(benchmark::State &state) {
+    auto a = randomMatrix(state.range(0)), b = randomMatrix(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((a - b).matrix.data());
+    }
+    reportCells(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_MatrixSubtract)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_MatrixScalarMultiply(benchmark::State &state) {
+    auto a = randomMatrix(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((a * std::int64_t{3}).matrix.data());
+    }
+    reportCells(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_MatrixScalarMultiply)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_MatrixMultiply(benchmark::State &state) {
+    auto a = randomMatrix(state.range(0)), b = randomMatrix(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize((a * b).matrix.data());
+    }
+    reportCells(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_MatrixMultiply)->RangeMultiplier(4)->Range(16, 256);
+
+void BM_MatrixTranspose(benchmark::State &state) {
+    auto a = randomMatrix(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.transpose().matrix.data());
+    }
+    reportCells(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_MatrixTranspose)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_MatrixPow(benchmark::State &state) {
+    auto a = randomMatrix(16);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.pow(state.range(0)).matrix.data());
+    }
+}
+BENCHMARK(BM_MatrixPow)->RangeMultiplier(8)->Range(2, 1 << 12);
+
+void BM_MatrixTrace(benchmark::State &state) {
+    auto a = randomMatrix(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.getTrace());
+    }
+}
+BENCHMARK(BM_MatrixTrace)->RangeMultiplier(4)->Range(16, 1024);
+
+// Cofactor expansion is factorial, only tiny sizes are meaningful.
+void BM_MatrixDeterminant(benchmark::State &state) {
+    auto a = randomMatrix(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a.getDeterminant());
+    }
+}
+BENCHMARK(BM_MatrixDeterminant)->DenseRange(2, 8, 2);
+
+}  // namespace
@@ -0,0 +1,82 @@
+#include "bench_utils.hpp"
+#include "rand.hpp"
+
+namespace {
+
+void reportItems(benchmark::State &state, std::uint64_t items) {
+    state.SetItemsProcessed(static_cast<std::int64_t>(items * state.iterations()));
+    state.counters["peak_rss_kb"] = peakRssKb();
+}
+
+void BM_IntFromRange(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rnd.intFromRange(0, 1000000000));
+    }
+    reportItems(state, 1);
+}
+BENCHMARK(BM_IntFromRange);
+
+// The same draws from a local generator, the difference to BM_IntFromRange is the cost of the thread_local `rnd`.
+void BM_IntFromRangeLocal(benchmark::State &state) {
+    Random random;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(random.intFromRange(0, 1000000000));
+    }
+    reportItems(state, 1);
+}
+BENCHMARK(BM_IntFromRangeLocal);
+
+void BM_IntsFromRange(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rnd.intsFromRange(state.range(0), 0, 1000000000).data());
+    }
+    reportItems(state, state.range(0));
+}
+BENCHMARK(BM_IntsFromRange)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_Perm(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rnd.perm(state.range(0)).data());
+    }
+    reportItems(state, state.range(0));
+}
+BENCHMARK(BM_Perm)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// Picks range(0) numbers out of 4 * range(0).
+void BM_Distinct(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rnd.distinct(state.range(0), 4 * state.range(0) - 1).data());
+    }
+    reportItems(state, state.range(0));
+}
+BENCHMARK(BM_Distinct)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+// Splits 10 * range(0) into range(0) parts.
+void BM_Partition(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rnd.partition(state.range(0), 10 * state.range(0)).data());
+    }
+    reportItems(state, state.range(0));
+}
+BENCHMARK(BM_Partition)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_SortedSampler(benchmark::State &state) {
+    for (auto _ : state) {
+        SortedSampler sampler(rnd, state.range(0), std::uint64_t{1} << 40);
+        while (sampler.hasNext()) {
+            benchmark::DoNotOptimize(sampler.next());
+        }
+    }
+    reportItems(state, state.range(0));
+}
+BENCHMARK(BM_SortedSampler)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+
+void BM_WeightedNumFromRange(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(rnd.weightedNumFromRange(1000000, state.range(0)));
+    }
+    reportItems(state, 1);
+}
+BENCHMARK(BM_WeightedNumFromRange)->Arg(-3)->Arg(0)->Arg(3);
+
+}  // namespace
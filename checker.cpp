@@ -0,0 +1,326 @@
+#include "checker.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status {};
+    if (fd < 0 || ::fstat(fd, &status) != 0) {
+        std::cerr << "Error: Could not open the file " << path.string() << ": " << std::strerror(errno) << std::endl;
+        exit(1);
+    }
+    size = static_cast<std::size_t>(status.st_size);
+    if (size > 0) {
+        void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Error: Could not map the file " << path.string() << ": " << std::strerror(errno)
+                      << std::endl;
+            exit(1);
+        }
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+        data = static_cast<const char *>(mapping);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (size > 0) {
+        ::munmap(const_cast<char *>(data), size);
+    }
+}
+
+namespace {
+
+std::string describe(std::string_view token) {
+    constexpr std::size_t maxLength = 32;
+    if (token.size() > maxLength) {
+        return '"' + std::string(token.substr(0, maxLength)) + "...\"";
+    }
+    return '"' + std::string(token) + '"';
+}
+
+std::string at(const TokenReader &reader) {
+    return "token " + std::to_string(reader.getTokenCount()) + ": ";
+}
+
+// Reads `count` integers from [min, max), the first reason to reject is stored in `verdict`.
+std::vector<std::int64_t> readIntegers(TokenReader &answer, std::uint64_t count, std::int64_t min, std::int64_t max,
+                                       Verdict &verdict) {
+    std::vector<std::int64_t> values(count);
+    for (auto &value : values) {
+        auto token = answer.readToken();
+        if (token.empty()) {
+            verdict = Verdict::reject("answer ends after " + std::to_string(answer.getTokenCount()) + " tokens");
+            return {};
+        }
+        auto parsed = TokenReader::parse<std::int64_t>(token);
+        if (!parsed || *parsed < min || *parsed >= max) {
+            verdict = Verdict::reject(at(answer) + "expected an integer in [" + std::to_string(min) + ", " +
+                                      std::to_string(max) + "), found " + describe(token));
+            return {};
+        }
+        value = *parsed;
+    }
+    return values;
+}
+
+Verdict expectEnd(TokenReader &answer) {
+    if (!answer.atEnd()) {
+        auto token = answer.readToken();
+        return Verdict::reject(at(answer) + "unexpected extra output " + describe(token));
+    }
+    return Verdict::accept();
+}
+
+class DisjointSets {
+public:
+    explicit DisjointSets(std::uint64_t n) : parent(n) {
+        std::iota(parent.begin(), parent.end(), std::uint64_t{0});
+    }
+
+    std::uint64_t find(std::uint64_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+
+    // Returns false if `u` and `v` were already in the same set.
+    bool unite(std::uint64_t u, std::uint64_t v) {
+        u = find(u);
+        v = find(v);
+        if (u == v) {
+            return false;
+        }
+        parent[std::max(u, v)] = std::min(u, v);
+        return true;
+    }
+
+private:
+    std::vector<std::uint64_t> parent;
+};
+
+}  // namespace
+
+Verdict compareTokens(TokenReader &expected, TokenReader &actual, double epsilon) {
+    TESTFRAME_SCOPED_TIMER("compareTokens");
+    while (true) {
+        const auto want = expected.readToken();
+        const auto got = actual.readToken();
+        if (want.empty() && got.empty()) {
+            return Verdict::accept();
+        }
+        if (got.empty()) {
+            return Verdict::reject(at(expected) + "answer ends early, expected " + describe(want));
+        }
+        if (want.empty()) {
+            return Verdict::reject(at(actual) + "unexpected extra output " + describe(got));
+        }
+        if (want == got) {
+            continue;
+        }
+        if (epsilon > 0) {
+            auto a = TokenReader::parse<double>(want), b = TokenReader::parse<double>(got);
+            if (a && b && std::abs(*a - *b) <= epsilon * std::max(1.0, std::abs(*a))) {
+                continue;
+            }
+        }
+        return Verdict::reject(at(expected) + "expected " + describe(want) + ", found " + describe(got));
+    }
+}
+
+Verdict compareFiles(const std::filesystem::path &expected, const std::filesystem::path &actual, double epsilon) {
+    MappedFile expectedFile(expected), actualFile(actual);
+    TokenReader expectedReader(expectedFile), actualReader(actualFile);
+    return compareTokens(expectedReader, actualReader, epsilon);
+}
+
+Verdict checkTopologicalOrder(const Graph &graph, TokenReader &answer) {
+    TESTFRAME_SCOPED_TIMER("checkTopologicalOrder");
+    assert(graph.directed);
+    const std::uint64_t n = graph.getNumberOfNodes();
+    Verdict verdict;
+    const auto order = readIntegers(answer, n, 0, static_cast<std::int64_t>(n), verdict);
+    if (!verdict || !(verdict = expectEnd(answer))) {
+        return verdict;
+    }
+    constexpr std::uint64_t unset = std::numeric_limits<std::uint64_t>::max();
+    std::vector<std::uint64_t> position(n, unset);
+    for (std::uint64_t i = 0; i < n; ++i) {
+        if (position[order[i]] != unset) {
+            return Verdict::reject("node " + std::to_string(order[i]) + " appears twice");
+        }
+        position[order[i]] = i;
+    }
+    for (std::uint64_t v = 0; v < n; ++v) {
+        for (auto u : graph.graph[v]) {
+            if (position[u] <= position[v]) {
+                return Verdict::reject("edge " + std::to_string(v) + " -> " + std::to_string(u) +
+                                       " goes backwards in the order");
+            }
+        }
+    }
+    return Verdict::accept();
+}
+
+Verdict checkShortestPathTree(const WeightedGraph &graph, std::uint64_t source, TokenReader &answer) {
+    TESTFRAME_SCOPED_TIMER("checkShortestPathTree");
+    const std::uint64_t n = graph.getNumberOfNodes();
+    assert(source < n);
+    Verdict verdict;
+    const auto parent = readIntegers(answer, n, -1, static_cast<std::int64_t>(n), verdict);
+    if (!verdict || !(verdict = expectEnd(answer))) {
+        return verdict;
+    }
+    if (parent[source] != static_cast<std::int64_t>(source)) {
+        return Verdict::reject("the source has to be its own parent");
+    }
+
+    // weight of the lightest edge parent[v] -> v
+    constexpr std::int64_t noEdge = std::numeric_limits<std::int64_t>::max();
+    std::vector<std::int64_t> treeWeight(n, noEdge);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        for (auto [u, weight] : graph.graph[v]) {
+            if (parent[u] == static_cast<std::int64_t>(v) && u != source) {
+                treeWeight[u] = std::min<std::int64_t>(treeWeight[u], weight);
+            }
+        }
+    }
+
+    // children in CSR form, then tree distances top-down from the source
+    std::vector<std::uint64_t> childStart(n + 1, 0), children;
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (v == source || parent[v] < 0) {
+            continue;
+        }
+        if (treeWeight[v] == noEdge) {
+            return Verdict::reject("parent edge " + std::to_string(parent[v]) + " -> " + std::to_string(v) +
+                                   " does not exist");
+        }
+        ++childStart[parent[v] + 1];
+    }
+    std::partial_sum(childStart.begin(), childStart.end(), childStart.begin());
+    children.resize(childStart[n]);
+    {
+        auto next = childStart;
+        for (std::uint64_t v = 0; v < n; ++v) {
+            if (v != source && parent[v] >= 0) {
+                children[next[parent[v]]++] = v;
+            }
+        }
+    }
+    std::vector<std::int64_t> distance(n, 0);
+    std::vector<char> reached(n, false);
+    std::vector<std::uint64_t> stack{source};
+    reached[source] = true;
+    std::uint64_t treeNodes = 1;
+    while (!stack.empty()) {
+        const std::uint64_t v = stack.back();
+        stack.pop_back();
+        for (std::uint64_t i = childStart[v]; i < childStart[v + 1]; ++i) {
+            const std::uint64_t u = children[i];
+            distance[u] = distance[v] + treeWeight[u];
+            reached[u] = true;
+            ++treeNodes;
+            stack.push_back(u);
+        }
+    }
+    const auto withParent = static_cast<std::uint64_t>(
+        std::count_if(parent.begin(), parent.end(), [](std::int64_t p) { return p >= 0; }));
+    if (treeNodes != withParent) {
+        return Verdict::reject("the parents contain a cycle");
+    }
+
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (!reached[v]) {
+            continue;
+        }
+        for (auto [u, weight] : graph.graph[v]) {
+            if (!reached[u]) {
+                return Verdict::reject("node " + std::to_string(u) + " is reachable but has parent -1");
+            }
+            if (distance[v] + weight < distance[u]) {
+                return Verdict::reject("edge " + std::to_string(v) + " -> " + std::to_string(u) +
+                                       " shortens the distance of node " + std::to_string(u));
+            }
+        }
+    }
+    return Verdict::accept();
+}
+
+Verdict checkMinimumSpanningForest(const WeightedGraph &graph, TokenReader &answer) {
+    TESTFRAME_SCOPED_TIMER("checkMinimumSpanningForest");
+    const std::uint64_t n = graph.getNumberOfNodes();
+    auto key = [](std::uint64_t u, std::uint64_t v) { return std::min(u, v) << 32 ^ std::max(u, v); };
+    assert(n <= (std::uint64_t{1} << 32));
+
+    std::unordered_map<std::uint64_t, std::int64_t> lightest;
+    lightest.reserve(graph.getNumberOfEdges());
+    std::vector<std::tuple<std::int64_t, NodeId, NodeId>> edges;
+    edges.reserve(graph.getNumberOfEdges());
+    for (std::uint64_t v = 0; v < n; ++v) {
+        for (auto [u, weight] : graph.graph[v]) {
+            auto [entry, inserted] = lightest.try_emplace(key(u, v), weight);
+            if (!inserted) {
+                entry->second = std::min<std::int64_t>(entry->second, weight);
+            }
+            edges.emplace_back(weight, static_cast<NodeId>(v), u);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    DisjointSets minimum(n);
+    std::int64_t minimumWeight = 0;
+    std::uint64_t forestEdges = 0;
+    for (auto [weight, v, u] : edges) {
+        if (minimum.unite(u, v)) {
+            minimumWeight += weight;
+            ++forestEdges;
+        }
+    }
+
+    Verdict verdict;
+    const auto count = readIntegers(answer, 1, 0, static_cast<std::int64_t>(n), verdict);
+    if (!verdict) {
+        return verdict;
+    }
+    if (static_cast<std::uint64_t>(count[0]) != forestEdges) {
+        return Verdict::reject("a spanning forest has " + std::to_string(forestEdges) + " edges, found " +
+                               std::to_string(count[0]));
+    }
+    const auto endpoints = readIntegers(answer, 2 * forestEdges, 0, static_cast<std::int64_t>(n), verdict);
+    if (!verdict || !(verdict = expectEnd(answer))) {
+        return verdict;
+    }
+    DisjointSets claimed(n);
+    std::int64_t claimedWeight = 0;
+    for (std::uint64_t i = 0; i < forestEdges; ++i) {
+        const auto u = static_cast<std::uint64_t>(endpoints[2 * i]), v = static_cast<std::uint64_t>(endpoints[2 * i + 1]);
+        auto edge = lightest.find(key(u, v));
+        if (edge == lightest.end()) {
+            return Verdict::reject("edge " + std::to_string(u) + " - " + std::to_string(v) + " does not exist");
+        }
+        if (!claimed.unite(u, v)) {
+            return Verdict::reject("edge " + std::to_string(u) + " - " + std::to_string(v) + " closes a cycle");
+        }
+        claimedWeight += edge->second;
+    }
+    if (claimedWeight != minimumWeight) {
+        return Verdict::reject("total weight " + std::to_string(claimedWeight) + " is not minimal, expected " +
+                               std::to_string(minimumWeight));
+    }
+    return Verdict::accept();
+}
@@ -0,0 +1,172 @@
+#ifndef CHECKER_H_
+#define CHECKER_H_
+
+#include "graph.hpp"
+#include "weighted_graph.hpp"
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+// Outcome of a check, `message` says what is wrong for rejected answers.
+struct Verdict {
+    bool accepted = true;
+    std::string message;
+
+    static Verdict accept() {
+        return {};
+    }
+
+    static Verdict reject(std::string message) {
+        return {false, std::move(message)};
+    }
+
+    explicit operator bool() const {
+        return accepted;
+    }
+};
+
+/**
+ * @brief Read-only memory mapping of a whole file, for judging outputs of several GB without copying them through
+ * iostreams. Errors are reported on `std::cerr` and end the program.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    std::string_view text() const {
+        return {data, size};
+    }
+
+private:
+    const char *data = nullptr;
+    std::size_t size = 0;
+};
+
+/**
+ * @brief Whitespace-separated tokens of a text, numbers are parsed in place with `std::from_chars`.
+ *
+ * Reads return `std::nullopt` at the end of the text or if the token is not a number of the requested type, the token
+ * is consumed either way. Any amount of whitespace separates tokens, so answers are accepted regardless of line breaks.
+ */
+class TokenReader {
+public:
+    explicit TokenReader(std::string_view text) : text(text) {}
+    explicit TokenReader(const MappedFile &file) : TokenReader(file.text()) {}
+
+    // Next token, empty at the end of the text.
+    std::string_view readToken() {
+        skipWhitespace();
+        const std::size_t begin = position;
+        while (position < text.size() && !isWhitespace(text[position])) {
+            ++position;
+        }
+        if (begin != position) {
+            ++tokens;
+        }
+        return text.substr(begin, position - begin);
+    }
+
+    template <typename T>
+    requires std::is_arithmetic_v<T>
+    std::optional<T> read() {
+        return parse<T>(readToken());
+    }
+
+    std::optional<std::int64_t> readInteger() {
+        return read<std::int64_t>();
+    }
+
+    std::optional<double> readDouble() {
+        return read<double>();
+    }
+
+    // Whether only whitespace is left.
+    bool atEnd() {
+        skipWhitespace();
+        return position == text.size();
+    }
+
+    // number of tokens read so far, for messages
+    std::uint64_t getTokenCount() const {
+        return tokens;
+    }
+
+    // Parses the whole of `token` as a `T`.
+    template <typename T>
+    requires std::is_arithmetic_v<T>
+    static std::optional<T> parse(std::string_view token) {
+        if (token.empty()) {
+            return std::nullopt;
+        }
+        // from_chars does not accept the leading '+' that iostreams do
+        if (token.front() == '+' && token.size() > 1 && token[1] != '-') {
+            token.remove_prefix(1);
+        }
+        T value{};
+        auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (error != std::errc{} || end != token.data() + token.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    static bool isWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    void skipWhitespace() {
+        while (position < text.size() && isWhitespace(text[position])) {
+            ++position;
+        }
+    }
+
+    std::string_view text;
+    std::size_t position = 0;
+    std::uint64_t tokens = 0;
+};
+
+/**
+ * @brief Streaming token-by-token comparison of an answer with the reference output, ignoring whitespace differences.
+ *
+ * With a positive `epsilon`, tokens that are both numbers match if they differ by at most `epsilon` absolutely or
+ * relative to the expected value; all other tokens have to be equal byte for byte.
+ */
+Verdict compareTokens(TokenReader &expected, TokenReader &actual, double epsilon = 0);
+Verdict compareFiles(const std::filesystem::path &expected, const std::filesystem::path &actual, double epsilon = 0);
+
+/**
+ * @brief Checks that `answer` contains a topological order of the directed `graph`: every node exactly once, and
+ * every edge going from an earlier to a later node. O(n + m).
+ */
+Verdict checkTopologicalOrder(const Graph &graph, TokenReader &answer);
+
+/**
+ * @brief Checks that `answer` contains a shortest path tree of `graph` from `source` as `n` parents: the source is its
+ * own parent and unreachable nodes have parent -1.
+ *
+ * Every tree edge has to exist, the tree has to reach exactly the nodes reachable from `source`, and no edge may
+ * shorten a tree distance, which makes the tree distances the shortest ones. O(n + m), weights may be negative as long
+ * as there is no negative cycle.
+ */
+Verdict checkShortestPathTree(const WeightedGraph &graph, std::uint64_t source, TokenReader &answer);
+
+/**
+ * @brief Checks that `answer` contains a minimum spanning forest of the undirected `graph` as a count `k` followed by
+ * `k` edges `u v`: all edges exist, they form a forest with as many components as the graph, and their total weight
+ * (using the lightest parallel edge) is minimal.
+ *
+ * The minimum weight comes from Kruskal's algorithm, so this takes O(m log m) rather than linear time.
+ */
+Verdict checkMinimumSpanningForest(const WeightedGraph &graph, TokenReader &answer);
+
+#endif
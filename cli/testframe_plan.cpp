@@ -0,0 +1,142 @@
+// Generates the tests of a test plan file (see `test_plan.hpp`) into `in/` and `solution-in/`, so a problem needs a
+// plan instead of a C++ main.
+
+#include "instrument.hpp"
+#include "registry.hpp"
+#include "test_plan.hpp"
+#include "utils.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+int usage() {
+    std::cerr << "usage: testframe_plan [options] <plan file, - for stdin>\n"
+                 "  --jobs <n>           tests generated at the same time, 0 uses all hardware threads (default)\n"
+                 "  --print-threads <n>  threads formatting each file (default 1)\n"
+                 "  --first-test <n>     number of the first test (default 1)\n"
+                 "  --cache <directory>  reuse tests from a test cache in <directory>\n"
+                 "  --compress           gzip the files, --level <1-9> sets the zlib level\n"
+                 "  --async              write the files from background threads\n"
+                 "  --report <path>      write the instrumentation report, .csv or .json\n"
+                 "  --dry-run            print the schedule without generating anything\n"
+                 "  --list               list the generators with their parameters\n";
+    return 2;
+}
+
+void listGenerators(const GeneratorRegistry &registry) {
+    for (const auto &[name, generator] : registry.getGenerators()) {
+        std::cout << generator.signature() << '\n';
+        for (const auto &parameter : generator.parameters) {
+            std::cout << "    " << std::left << std::setw(20) << parameter.name << parameter.description << '\n';
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    PlanOptions options;
+    std::string planPath, reportPath;
+    std::uint64_t firstTest = 1;
+    bool dryRun = false, list = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 == argc) {
+                std::cerr << "Error: " << arg << " needs a value" << std::endl;
+                exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--jobs") {
+            options.jobs = static_cast<unsigned>(std::stoul(value()));
+        } else if (arg == "--print-threads") {
+            options.printThreads = static_cast<unsigned>(std::stoul(value()));
+        } else if (arg == "--first-test") {
+            firstTest = std::stoull(value());
+        } else if (arg == "--cache") {
+            options.cacheDirectory = value();
+        } else if (arg == "--compress") {
+            options.output.compress = true;
+        } else if (arg == "--level") {
+            options.output.level = std::stoi(value());
+        } else if (arg == "--async") {
+            options.output.asyncWrite = true;
+        } else if (arg == "--report") {
+            reportPath = value();
+        } else if (arg == "--dry-run") {
+            dryRun = true;
+        } else if (arg == "--list") {
+            list = true;
+        } else if (planPath.empty() && (arg == "-" || !arg.starts_with("--"))) {
+            planPath = arg;
+        } else {
+            return usage();
+        }
+    }
+
+    const auto registry = GeneratorRegistry::builtin();
+    if (list) {
+        listGenerators(registry);
+        return 0;
+    }
+    if (planPath.empty()) {
+        return usage();
+    }
+    if (!options.cacheDirectory.empty() && (options.output.compress || options.output.asyncWrite)) {
+        std::cerr << "Error: the test cache stores plain files, --cache cannot be combined with --compress or --async"
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<PlannedTest> tests;
+    if (planPath == "-") {
+        tests = readTestPlan(std::cin, registry, "stdin", firstTest);
+    } else {
+        std::ifstream plan(planPath);
+        if (!plan) {
+            std::cerr << "Error: Could not open the file " << planPath << std::endl;
+            return 1;
+        }
+        tests = readTestPlan(plan, registry, planPath, firstTest);
+    }
+
+    if (dryRun) {
+        for (const auto *test : scheduleTestPlan(tests)) {
+            std::cout << "test " << test->testNumber << " (line " << test->line << ", cost " << test->cost
+                      << "): " << test->generator->name << " seed=" << test->seed;
+            for (const auto &[name, value] : test->arguments.getValues()) {
+                std::cout << ' ' << name << '=' << value;
+            }
+            std::cout << '\n';
+        }
+        return 0;
+    }
+
+    for (const auto &[key, directory] : dirs) {
+        std::filesystem::create_directories(directory);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto summary = runTestPlan(tests, options);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Generated " << summary.tests << " tests";
+    if (!options.cacheDirectory.empty()) {
+        std::cout << " (" << summary.cacheHits << " from the cache)";
+    }
+    std::cout << " in " << std::fixed << std::setprecision(2) << elapsed.count() << " s" << std::endl;
+
+    if (!reportPath.empty()) {
+#ifndef TESTFRAME_INSTRUMENT
+        std::cerr << "Warning: testframe was built without TESTFRAME_INSTRUMENTATION, the report has no phases"
+                  << std::endl;
+#endif
+        Instrumentation::writeReport(reportPath);
+    }
+    return 0;
+}
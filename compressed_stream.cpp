@@ -0,0 +1,218 @@
+#include "compressed_stream.hpp"
+#include "instrument.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// gzip header and trailer around the deflate data
+constexpr int gzipWindowBits = 15 + 16;
+// accept both gzip and zlib headers
+constexpr int autoDetectWindowBits = 15 + 32;
+
+std::vector<unsigned char> compressMember(const char *data, std::size_t size, int level) {
+    z_stream stream{};
+    if (deflateInit2(&stream, level, Z_DEFLATED, gzipWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        std::cerr << "Error: Could not initialize gzip compression" << std::endl;
+        exit(1);
+    }
+    std::vector<unsigned char> member(deflateBound(&stream, size));
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = member.data();
+    stream.avail_out = static_cast<uInt>(member.size());
+    [[maybe_unused]] int result = deflate(&stream, Z_FINISH);
+    assert(result == Z_STREAM_END);
+    member.resize(stream.total_out);
+    deflateEnd(&stream);
+    return member;
+}
+
+}  // namespace
+
+GzipOutputBuffer::GzipOutputBuffer(std::ostream &sink, int level, unsigned threads, std::size_t blockSize)
+    : sink(sink),
+      level(level),
+      threads(resolveThreadCount(threads)),
+      blockSize(blockSize),
+      buffer(this->threads * blockSize) {
+    // deflate takes the block size as a 32-bit count
+    assert(blockSize > 0 && blockSize <= (1u << 30));
+    setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+GzipOutputBuffer::~GzipOutputBuffer() {
+    finish();
+}
+
+void GzipOutputBuffer::finish() {
+    if (finished) {
+        return;
+    }
+    compressBuffer();
+    if (!wroteMember) {
+        // An empty file is still a valid gzip stream.
+        auto member = compressMember(nullptr, 0, level);
+        sink.write(reinterpret_cast<const char *>(member.data()), static_cast<std::streamsize>(member.size()));
+    }
+    sink.flush();
+    finished = true;
+}
+
+void GzipOutputBuffer::compressBuffer() {
+    TESTFRAME_SCOPED_TIMER("GzipOutputBuffer::compress");
+    const std::size_t size = pptr() - pbase();
+    const std::size_t blocks = (size + blockSize - 1) / blockSize;
+    std::vector<std::vector<unsigned char>> members(blocks);
+    parallelForChunks(0, blocks, threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+        for (std::uint64_t block = from; block < to; ++block) {
+            std::size_t begin = block * blockSize;
+            members[block] = compressMember(pbase() + begin, std::min(blockSize, size - begin), level);
+        }
+    }, 1);
+    for (const auto &member : members) {
+        sink.write(reinterpret_cast<const char *>(member.data()), static_cast<std::streamsize>(member.size()));
+    }
+    wroteMember |= blocks > 0;
+    flushedBytes += size;
+    setp(buffer.data(), buffer.data() + buffer.size());
+}
+
+GzipOutputBuffer::int_type GzipOutputBuffer::overflow(int_type ch) {
+    assert(!finished);
+    compressBuffer();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize GzipOutputBuffer::xsputn(const char *data, std::streamsize size) {
+    std::streamsize written = 0;
+    while (written < size) {
+        if (pptr() == epptr()) {
+            compressBuffer();
+        }
+        std::streamsize chunk = std::min<std::streamsize>(size - written, epptr() - pptr());
+        std::memcpy(pptr(), data + written, static_cast<std::size_t>(chunk));
+        pbump(static_cast<int>(chunk));
+        written += chunk;
+    }
+    return written;
+}
+
+GzipOutputBuffer::pos_type GzipOutputBuffer::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                     std::ios_base::openmode which) {
+    if (off != 0 || dir != std::ios_base::cur || !(which & std::ios_base::out)) {
+        return pos_type(off_type(-1));
+    }
+    return pos_type(static_cast<off_type>(flushedBytes + (pptr() - pbase())));
+}
+
+GzipInputBuffer::GzipInputBuffer(std::istream &source) : source(source), input(1 << 16), output(1 << 16) {
+    if (inflateInit2(&stream, autoDetectWindowBits) != Z_OK) {
+        std::cerr << "Error: Could not initialize gzip decompression" << std::endl;
+        exit(1);
+    }
+}
+
+GzipInputBuffer::~GzipInputBuffer() {
+    inflateEnd(&stream);
+}
+
+GzipInputBuffer::int_type GzipInputBuffer::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    stream.next_out = reinterpret_cast<Bytef *>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+    while (stream.avail_out == output.size()) {
+        if (stream.avail_in == 0) {
+            source.read(input.data(), static_cast<std::streamsize>(input.size()));
+            stream.next_in = reinterpret_cast<Bytef *>(input.data());
+            stream.avail_in = static_cast<uInt>(source.gcount());
+            if (stream.avail_in == 0) {
+                if (insideMember) {
+                    // the input was cut off before the end of the last member
+                    std::cerr << "Error: Corrupt gzip input" << std::endl;
+                    exit(1);
+                }
+                return traits_type::eof();
+            }
+        }
+        int result = inflate(&stream, Z_NO_FLUSH);
+        insideMember = result == Z_OK;
+        if (result == Z_STREAM_END) {
+            // The next gzip member, if any, continues the same text.
+            inflateReset(&stream);
+        } else if (result != Z_OK) {
+            std::cerr << "Error: Corrupt gzip input" << std::endl;
+            exit(1);
+        }
+    }
+    setg(output.data(), output.data(), output.data() + (output.size() - stream.avail_out));
+    return traits_type::to_int_type(*gptr());
+}
+
+namespace {
+
+std::unique_ptr<std::ostream> openBinaryFile(const std::filesystem::path &path) {
+    auto file = std::make_unique<std::ofstream>(path, std::ios::binary);
+    if (!*file) {
+        std::cerr << "Error: Could not open the file " << path.string() << std::endl;
+        exit(1);
+    }
+    return file;
+}
+
+}  // namespace
+
+GzipOutputFile::GzipOutputFile(const std::filesystem::path &path, int level, unsigned threads)
+    : GzipOutputFile(openBinaryFile(path), level, threads) {}
+
+GzipOutputFile::GzipOutputFile(std::unique_ptr<std::ostream> file, int level, unsigned threads)
+    : std::ostream(nullptr),
+      file(std::move(file)),
+      buffer(std::make_unique<GzipOutputBuffer>(*this->file, level, threads)) {
+    rdbuf(buffer.get());
+}
+
+GzipOutputFile::~GzipOutputFile() {
+    close();
+}
+
+void GzipOutputFile::close() {
+    if (buffer) {
+        buffer->finish();
+        file.reset();
+    }
+}
+
+GzipInputFile::GzipInputFile(const std::filesystem::path &path) : std::istream(nullptr), file(path, std::ios::binary) {
+    if (!file) {
+        std::cerr << "Error: Could not open the file " << path.string() << std::endl;
+        exit(1);
+    }
+    buffer = std::make_unique<GzipInputBuffer>(file);
+    rdbuf(buffer.get());
+}
+
+std::unique_ptr<std::istream> openInputFile(const std::filesystem::path &path) {
+    char magic[2] = {};
+    {
+        std::ifstream probe(path, std::ios::binary);
+        if (!probe) {
+            std::cerr << "Error: Could not open the file " << path.string() << std::endl;
+            exit(1);
+        }
+        probe.read(magic, 2);
+    }
+    if (magic[0] == '\x1f' && magic[1] == '\x8b') {
+        return std::make_unique<GzipInputFile>(path);
+    }
+    return std::make_unique<std::ifstream>(path);
+}
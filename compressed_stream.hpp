@@ -0,0 +1,106 @@
+#ifndef COMPRESSED_STREAM_H_
+#define COMPRESSED_STREAM_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <streambuf>
+#include <vector>
+#include <zlib.h>
+
+/**
+ * @brief Output buffer that gzips everything written through it into `sink`.
+ *
+ * Text is cut into blocks of `blockSize` bytes and every block becomes an independent gzip member, so `threads`
+ * blocks are compressed at once and `gzip -d`, `zcat` and `GzipInputBuffer` read the concatenation as one file.
+ * Splitting costs well under 1% of the compressed size at the default block size. `sync` does not cut a block, the
+ * output is complete after `finish` or destruction.
+ */
+class GzipOutputBuffer : public std::streambuf {
+public:
+    static constexpr std::size_t defaultBlockSize = 1 << 20;
+
+    // `level` is the zlib level from 1 (fastest) to 9 (smallest), 0 for `threads` uses all hardware threads.
+    explicit GzipOutputBuffer(std::ostream &sink, int level = 6, unsigned threads = 1,
+                              std::size_t blockSize = defaultBlockSize);
+    ~GzipOutputBuffer() override;
+
+    GzipOutputBuffer(const GzipOutputBuffer &) = delete;
+    GzipOutputBuffer &operator=(const GzipOutputBuffer &) = delete;
+
+    // Compresses the buffered text and writes it to `sink`; nothing may be written afterwards.
+    void finish();
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *data, std::streamsize size) override;
+    // Only reports the position, the number of uncompressed bytes written so far, e.g. for `tellp`.
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+
+private:
+    void compressBuffer();
+
+    std::ostream &sink;
+    int level;
+    unsigned threads;
+    std::size_t blockSize;
+    std::vector<char> buffer;
+    std::uint64_t flushedBytes = 0;
+    bool wroteMember = false;
+    bool finished = false;
+};
+
+/**
+ * @brief Input buffer that inflates gzip (including concatenated members, as written by `GzipOutputBuffer`) or zlib
+ * data read from `source`. Corrupt or truncated input is reported on `std::cerr` and ends the program.
+ */
+class GzipInputBuffer : public std::streambuf {
+public:
+    explicit GzipInputBuffer(std::istream &source);
+    ~GzipInputBuffer() override;
+
+    GzipInputBuffer(const GzipInputBuffer &) = delete;
+    GzipInputBuffer &operator=(const GzipInputBuffer &) = delete;
+
+protected:
+    int_type underflow() override;
+
+private:
+    std::istream &source;
+    z_stream stream{};
+    std::vector<char> input;
+    std::vector<char> output;
+    // a member has been started and its end not reached yet
+    bool insideMember = false;
+};
+
+// Gzipped file opened for writing, complete once closed or destroyed.
+class GzipOutputFile : public std::ostream {
+public:
+    explicit GzipOutputFile(const std::filesystem::path &path, int level = 6, unsigned threads = 1);
+    // Compresses into `file`, e.g. an `AsyncOutputFile`, which is closed by destroying it.
+    explicit GzipOutputFile(std::unique_ptr<std::ostream> file, int level = 6, unsigned threads = 1);
+    ~GzipOutputFile() override;
+
+    void close();
+
+private:
+    std::unique_ptr<std::ostream> file;
+    std::unique_ptr<GzipOutputBuffer> buffer;
+};
+
+// Gzipped file opened for reading, e.g. for `Graph::readGraph`.
+class GzipInputFile : public std::istream {
+public:
+    explicit GzipInputFile(const std::filesystem::path &path);
+
+private:
+    std::ifstream file;
+    std::unique_ptr<GzipInputBuffer> buffer;
+};
+
+// Opens `path` for reading, decompressing it when it starts with the gzip magic bytes.
+std::unique_ptr<std::istream> openInputFile(const std::filesystem::path &path);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef CSR_GRAPH_H_
+#define CSR_GRAPH_H_
+
+#include "graph.hpp"
+#include "graph_view.hpp"
+#include "instrument.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Immutable graph in compressed sparse row form: the neighbours of `v` are
+ * targets[offsets[v]], ..., targets[offsets[v + 1] - 1].
+ *
+ * Two flat arrays instead of one vector per node, so building it costs two allocations. It is `GraphLike`, so it
+ * prints, validates and traverses like `Graph`.
+ */
+class CsrGraph {
+public:
+    bool directed = false;
+    std::vector<std::uint64_t> offsets;
+    std::vector<NodeId> targets;
+
+    CsrGraph(std::vector<std::uint64_t> offsets, std::vector<NodeId> targets, bool directed = false)
+        : directed(directed), offsets(std::move(offsets)), targets(std::move(targets)) {}
+
+    std::uint64_t getNumberOfNodes() const {
+        return offsets.size() - 1;
+    }
+
+    std::uint64_t getNumberOfEdges() const {
+        return targets.size();
+    }
+
+    std::uint64_t getDegree(std::uint64_t node) const {
+        return offsets[node + 1] - offsets[node];
+    }
+
+    template <typename F>
+    void forEachNeighbor(std::uint64_t node, F &&f) const {
+        for (std::uint64_t i = offsets[node]; i < offsets[node + 1]; ++i) {
+            if (!visitNeighbor(f, targets[i])) {
+                return;
+            }
+        }
+    }
+
+    void printTo(std::ostream &outputStream, Graph::PrintFormat format, unsigned threads = 1) const {
+        TESTFRAME_SCOPED_TIMER("CsrGraph::printTo");
+        TESTFRAME_COUNT_BYTES_WRITTEN(outputStream);
+        printGraphTo(*this, outputStream, format, threads);
+    }
+
+    Graph toGraph() const {
+        std::vector<std::vector<NodeId>> g(getNumberOfNodes());
+        for (std::uint64_t v = 0; v < getNumberOfNodes(); ++v) {
+            g[v].assign(targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+        }
+        return Graph(std::move(g), directed);
+    }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef DAG_LAYOUT_H_
+#define DAG_LAYOUT_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Numbering of the candidate edges of a layered DAG, shared by `Graph` and `EdgeStream`.
+ *
+ * Nodes are numbered layer by layer, so layer `L` is [layerStart[L], layerStart[L + 1]) and every node may point to
+ * any node of a lower layer, i.e. node `u` of layer `L` has the candidates [0, layerStart[L]). Candidates are numbered
+ * node by node, so a sorted sample of candidate numbers decodes to edges grouped by source with sorted targets.
+ */
+class DagLayout {
+public:
+    explicit DagLayout(const std::vector<std::uint64_t> &layerSizes)
+        : layerStart(layerSizes.size() + 1, 0), pairsBefore(layerSizes.size() + 1, 0) {
+        assert(!layerSizes.empty());
+        for (std::size_t layer = 0; layer < layerSizes.size(); ++layer) {
+            layerStart[layer + 1] = layerStart[layer] + layerSizes[layer];
+            pairsBefore[layer + 1] = pairsBefore[layer] + layerSizes[layer] * layerStart[layer];
+        }
+    }
+
+    std::uint64_t getNumberOfNodes() const {
+        return layerStart.back();
+    }
+
+    std::uint64_t getNumberOfPairs() const {
+        return pairsBefore.back();
+    }
+
+    std::size_t getLayer(std::uint64_t node) const {
+        return std::upper_bound(layerStart.begin(), layerStart.end(), node) - layerStart.begin() - 1;
+    }
+
+    std::uint64_t getLayerStart(std::size_t layer) const {
+        return layerStart[layer];
+    }
+
+    // number of the first candidate edge of `node`, which lies in `layer`
+    std::uint64_t getFirstPair(std::uint64_t node, std::size_t layer) const {
+        return pairsBefore[layer] + (node - layerStart[layer]) * layerStart[layer];
+    }
+
+    /**
+     * @brief Returns the edge (from, to) with number `pair`.
+     *
+     * `layer` is a hint that must not be past the layer of the source, it is advanced to that layer, so decoding
+     * increasing numbers costs O(1) amortized.
+     */
+    std::pair<std::uint64_t, std::uint64_t> decode(std::uint64_t pair, std::size_t &layer) const {
+        while (pair >= pairsBefore[layer + 1]) {
+            ++layer;
+        }
+        std::uint64_t offset = pair - pairsBefore[layer];
+        return {layerStart[layer] + offset / layerStart[layer], offset % layerStart[layer]};
+    }
+
+private:
+    std::vector<std::uint64_t> layerStart;
+    std::vector<std::uint64_t> pairsBefore;
+};
+
+#endif
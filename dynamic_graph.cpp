@@ -0,0 +1,259 @@
+#include "dynamic_graph.hpp"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+namespace {
+
+std::uint64_t hashPair(std::uint64_t a, std::uint64_t b) {
+    std::uint64_t x = a * 0x9e3779b97f4a7c15ULL ^ (b + 0x632be59bd9b4e019ULL);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}  // namespace
+
+std::uint64_t DynamicGraph::EdgeIndex::slotOf(Key key) const {
+    return hashPair(key.first, key.second) & (slots.size() - 1);
+}
+
+std::uint64_t DynamicGraph::EdgeIndex::find(Key key) const {
+    if (slots.empty()) {
+        return noEdge;
+    }
+    for (std::uint64_t slot = slotOf(key);; slot = (slot + 1) & (slots.size() - 1)) {
+        if (slots[slot].key == key) {
+            return slots[slot].edge;
+        }
+        if (slots[slot].key.first == emptySlot) {
+            return noEdge;
+        }
+    }
+}
+
+void DynamicGraph::EdgeIndex::insert(Key key, std::uint64_t edge) {
+    // at most half full, so probe sequences stay short
+    if (2 * (size + 1) > slots.size()) {
+        grow(std::max<std::uint64_t>(16, 2 * slots.size()));
+    }
+    std::uint64_t slot = slotOf(key);
+    while (slots[slot].key.first != emptySlot) {
+        slot = (slot + 1) & (slots.size() - 1);
+    }
+    slots[slot] = {key, edge};
+    ++size;
+}
+
+void DynamicGraph::EdgeIndex::update(Key key, std::uint64_t edge) {
+    std::uint64_t slot = slotOf(key);
+    while (slots[slot].key != key) {
+        slot = (slot + 1) & (slots.size() - 1);
+    }
+    slots[slot].edge = edge;
+}
+
+void DynamicGraph::EdgeIndex::erase(Key key) {
+    const std::uint64_t mask = slots.size() - 1;
+    std::uint64_t hole = slotOf(key);
+    while (slots[hole].key != key) {
+        hole = (hole + 1) & mask;
+    }
+    // Backward shift: later entries of the run move into the hole unless that would put them before their home slot.
+    for (std::uint64_t slot = (hole + 1) & mask; slots[slot].key.first != emptySlot; slot = (slot + 1) & mask) {
+        std::uint64_t home = slotOf(slots[slot].key);
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            slots[hole] = slots[slot];
+            hole = slot;
+        }
+    }
+    slots[hole] = Slot{};
+    --size;
+}
+
+void DynamicGraph::EdgeIndex::reserve(std::uint64_t entries) {
+    std::uint64_t capacity = std::max<std::uint64_t>(16, slots.size());
+    while (2 * entries > capacity) {
+        capacity *= 2;
+    }
+    if (capacity > slots.size()) {
+        grow(capacity);
+    }
+}
+
+void DynamicGraph::EdgeIndex::grow(std::uint64_t capacity) {
+    std::vector<Slot> old(capacity);
+    std::swap(old, slots);
+    size = 0;
+    for (const auto &slot : old) {
+        if (slot.key.first != emptySlot) {
+            insert(slot.key, slot.edge);
+        }
+    }
+}
+
+DynamicGraph::DynamicGraph(std::uint64_t nodes, bool directed) : directed(directed) {
+    addNodes(nodes);
+}
+
+DynamicGraph::DynamicGraph(const Graph &graph) : DynamicGraph(graph.getNumberOfNodes(), graph.directed) {
+    TESTFRAME_SCOPED_TIMER("DynamicGraph::DynamicGraph");
+    index.reserve(directed ? graph.getNumberOfEdges() : graph.getNumberOfEdges() / 2);
+    for (std::uint64_t v = 0; v < graph.getNumberOfNodes(); ++v) {
+        for (auto u : graph.graph[v]) {
+            addEdge(v, u);
+        }
+    }
+}
+
+bool DynamicGraph::addEdge(std::uint64_t from, std::uint64_t to) {
+    assert(from < getNumberOfNodes() && to < getNumberOfNodes());
+    if (from == to) {
+        return false;
+    }
+    const Key k = key(from, to);
+    if (index.find(k) != noEdge) {
+        return false;
+    }
+    const std::uint64_t edge = edges.size();
+    edges.push_back({static_cast<NodeId>(from), static_cast<NodeId>(to), adjacency[from].size(),
+                     adjacency[to].size()});
+    adjacency[from].push_back({static_cast<NodeId>(to), edge});
+    if (!directed) {
+        adjacency[to].push_back({static_cast<NodeId>(from), edge});
+    }
+    index.insert(k, edge);
+    if (!componentsStale) {
+        unite(from, to);
+    }
+    return true;
+}
+
+bool DynamicGraph::removeEdge(std::uint64_t from, std::uint64_t to) {
+    const Key k = key(from, to);
+    const std::uint64_t edge = index.find(k);
+    if (edge == noEdge) {
+        return false;
+    }
+    const EdgeRecord record = edges[edge];
+    removeEntry(record.from, record.fromPosition);
+    if (!directed) {
+        removeEntry(record.to, record.toPosition);
+    }
+    index.erase(k);
+
+    // The last record fills the hole, its entries and index slot follow it.
+    if (edge != edges.size() - 1) {
+        const EdgeRecord &moved = edges[edge] = edges.back();
+        adjacency[moved.from][moved.fromPosition].edge = edge;
+        if (!directed) {
+            adjacency[moved.to][moved.toPosition].edge = edge;
+        }
+        index.update(key(moved.from, moved.to), edge);
+    }
+    edges.pop_back();
+    componentsStale = true;
+    return true;
+}
+
+void DynamicGraph::removeEntry(std::uint64_t node, std::uint64_t position) {
+    auto &list = adjacency[node];
+    if (position != list.size() - 1) {
+        list[position] = list.back();
+        positionIn(edges[list[position].edge], node) = position;
+    }
+    list.pop_back();
+}
+
+std::uint64_t DynamicGraph::applyBatch(const std::vector<Edge> &removals, const std::vector<Edge> &insertions) {
+    TESTFRAME_SCOPED_TIMER("DynamicGraph::applyBatch");
+    std::uint64_t applied = 0;
+    for (auto [from, to] : removals) {
+        applied += removeEdge(from, to);
+    }
+    index.reserve(edges.size() + insertions.size());
+    edges.reserve(edges.size() + insertions.size());
+    for (auto [from, to] : insertions) {
+        applied += addEdge(from, to);
+    }
+    return applied;
+}
+
+void DynamicGraph::addNodes(std::uint64_t count) {
+    const std::uint64_t first = getNumberOfNodes();
+    // the largest id marks empty slots of the index
+    assert(first + count < std::numeric_limits<NodeId>::max());
+    adjacency.resize(first + count);
+    parent.resize(first + count);
+    componentSize.resize(first + count, 1);
+    std::iota(parent.begin() + first, parent.end(), static_cast<NodeId>(first));
+    components += count;
+}
+
+DynamicGraph::Edge DynamicGraph::randomEdge(Random &random) const {
+    assert(!edges.empty());
+    const EdgeRecord &record = edges[random.intFromRange(edges.size() - 1)];
+    if (!directed && random.intFromRange(1) == 1) {
+        return {record.to, record.from};
+    }
+    return {record.from, record.to};
+}
+
+std::uint64_t DynamicGraph::findRoot(std::uint64_t node) {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+void DynamicGraph::unite(std::uint64_t u, std::uint64_t v) {
+    u = findRoot(u);
+    v = findRoot(v);
+    if (u == v) {
+        return;
+    }
+    if (componentSize[u] < componentSize[v]) {
+        std::swap(u, v);
+    }
+    parent[v] = static_cast<NodeId>(u);
+    componentSize[u] += componentSize[v];
+    --components;
+}
+
+void DynamicGraph::rebuildComponents() {
+    TESTFRAME_SCOPED_TIMER("DynamicGraph::rebuildComponents");
+    std::iota(parent.begin(), parent.end(), NodeId{0});
+    std::fill(componentSize.begin(), componentSize.end(), 1);
+    components = getNumberOfNodes();
+    for (const auto &record : edges) {
+        unite(record.from, record.to);
+    }
+    componentsStale = false;
+}
+
+std::uint64_t DynamicGraph::getNumberOfComponents() {
+    if (componentsStale) {
+        rebuildComponents();
+    }
+    return components;
+}
+
+bool DynamicGraph::connected(std::uint64_t u, std::uint64_t v) {
+    if (componentsStale) {
+        rebuildComponents();
+    }
+    return findRoot(u) == findRoot(v);
+}
+
+Graph DynamicGraph::toGraph() const {
+    TESTFRAME_SCOPED_TIMER("DynamicGraph::toGraph");
+    std::vector<std::vector<NodeId>> g(getNumberOfNodes());
+    for (std::uint64_t v = 0; v < getNumberOfNodes(); ++v) {
+        g[v].reserve(adjacency[v].size());
+        for (const auto &entry : adjacency[v]) {
+            g[v].push_back(entry.node);
+        }
+    }
+    return Graph(std::move(g), directed);
+}
@@ -0,0 +1,159 @@
+#ifndef DYNAMIC_GRAPH_H_
+#define DYNAMIC_GRAPH_H_
+
+#include "graph.hpp"
+#include "graph_view.hpp"
+#include "instrument.hpp"
+#include "rand.hpp"
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Simple graph under edge insertions and deletions, both O(1) expected, for generators that edit a graph many
+ * times, e.g. hill climbing towards a worst case.
+ *
+ * Every edge has a record with its position in the adjacency list of each endpoint, and a hash table finds the
+ * record of a node pair. Deleting moves the last entry of each list (and the last record) into the hole, so
+ * neighbour order changes. The graph stays free of self-loops and repeated edges, and undirected edges are always
+ * listed at both endpoints, so `toGraph().normalize()` only has to sort. Connected components are kept in a
+ * union-find structure that insertions update directly; a deletion marks it stale and the next query rebuilds it.
+ */
+class DynamicGraph {
+public:
+    using Edge = std::pair<std::uint64_t, std::uint64_t>;
+
+    bool directed = false;
+
+    explicit DynamicGraph(std::uint64_t nodes = 0, bool directed = false);
+    // Copies the edges of `graph`, dropping self-loops and repeated edges.
+    explicit DynamicGraph(const Graph &graph);
+
+    std::uint64_t getNumberOfNodes() const {
+        return adjacency.size();
+    }
+
+    // number of adjacency entries, like `Graph::getNumberOfEdges`
+    std::uint64_t getNumberOfEdges() const {
+        return directed ? edges.size() : 2 * edges.size();
+    }
+
+    // number of edges, every undirected edge counted once
+    std::uint64_t getNumberOfDistinctEdges() const {
+        return edges.size();
+    }
+
+    std::uint64_t getDegree(std::uint64_t node) const {
+        return adjacency[node].size();
+    }
+
+    template <typename F>
+    void forEachNeighbor(std::uint64_t node, F &&f) const {
+        for (const auto &entry : adjacency[node]) {
+            if (!visitNeighbor(f, entry.node)) {
+                return;
+            }
+        }
+    }
+
+    bool hasEdge(std::uint64_t from, std::uint64_t to) const {
+        return index.find(key(from, to)) != noEdge;
+    }
+
+    // Returns false, and changes nothing, for self-loops and edges that are already present.
+    bool addEdge(std::uint64_t from, std::uint64_t to);
+    // Returns false if there is no such edge.
+    bool removeEdge(std::uint64_t from, std::uint64_t to);
+
+    // Applies the removals, then the insertions, and returns how many of them changed the graph.
+    std::uint64_t applyBatch(const std::vector<Edge> &removals, const std::vector<Edge> &insertions);
+
+    // Appends `count` isolated nodes.
+    void addNodes(std::uint64_t count);
+
+    // Uniformly random edge, with its endpoints in random order for undirected graphs. The graph must have an edge.
+    Edge randomEdge(Random &random = rnd) const;
+
+    std::uint64_t getNumberOfComponents();
+    // Whether `u` and `v` are in the same weakly connected component.
+    bool connected(std::uint64_t u, std::uint64_t v);
+
+    // Snapshot with the current neighbour order.
+    Graph toGraph() const;
+
+private:
+    static constexpr std::uint64_t noEdge = std::numeric_limits<std::uint64_t>::max();
+
+    struct Entry {
+        NodeId node;
+        // position of the record in `edges`
+        std::uint64_t edge;
+    };
+
+    struct EdgeRecord {
+        NodeId from;
+        NodeId to;
+        // positions of the entries in adjacency[from] and, for undirected graphs, adjacency[to]
+        std::uint64_t fromPosition;
+        std::uint64_t toPosition;
+    };
+
+    using Key = std::pair<NodeId, NodeId>;
+
+    /**
+     * @brief Open addressing map from node pairs to record positions with linear probing, deletions shift the
+     * following entries back so no tombstones accumulate.
+     */
+    class EdgeIndex {
+    public:
+        std::uint64_t find(Key key) const;
+        void insert(Key key, std::uint64_t edge);
+        void update(Key key, std::uint64_t edge);
+        void erase(Key key);
+        void reserve(std::uint64_t size);
+
+    private:
+        static constexpr NodeId emptySlot = std::numeric_limits<NodeId>::max();
+
+        struct Slot {
+            Key key{emptySlot, emptySlot};
+            std::uint64_t edge = noEdge;
+        };
+
+        std::uint64_t slotOf(Key key) const;
+        void grow(std::uint64_t capacity);
+
+        std::vector<Slot> slots;
+        std::uint64_t size = 0;
+    };
+
+    Key key(std::uint64_t from, std::uint64_t to) const {
+        if (!directed && to < from) {
+            std::swap(from, to);
+        }
+        return {static_cast<NodeId>(from), static_cast<NodeId>(to)};
+    }
+
+    // Removes adjacency[node][position] by moving the last entry into its place.
+    void removeEntry(std::uint64_t node, std::uint64_t position);
+    std::uint64_t &positionIn(EdgeRecord &record, std::uint64_t node) {
+        return record.from == node ? record.fromPosition : record.toPosition;
+    }
+
+    std::uint64_t findRoot(std::uint64_t node);
+    void unite(std::uint64_t u, std::uint64_t v);
+    void rebuildComponents();
+
+    std::vector<std::vector<Entry>> adjacency;
+    std::vector<EdgeRecord> edges;
+    EdgeIndex index;
+
+    // union-find over the nodes, valid while `componentsStale` is false
+    std::vector<NodeId> parent;
+    std::vector<NodeId> componentSize;
+    std::uint64_t components = 0;
+    bool componentsStale = false;
+};
+
+#endif
@@ -0,0 +1,502 @@
+#include "edge_stream.hpp"
+#include "rand.hpp"
+#include "dag_layout.hpp"
+#include "grid_layout.hpp"
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <queue>
+
+EdgeStream::EdgeStream(std::uint64_t nodes, std::uint64_t edges, bool directed, Producer producer, bool relabel)
+    : directed(directed),
+      nodes(nodes),
+      edges(edges),
+      producer(std::move(producer)) {
+    if (relabel) {
+        perm = rnd.perm<NodeId>(nodes);
+    }
+}
+
+bool EdgeStream::nextChunk(std::vector<Edge> &chunk) {
+    chunk.clear();
+    while (chunk.empty() && producer) {
+        if (!producer(chunk)) {
+            producer = nullptr;
+        }
+    }
+    if (!perm.empty()) {
+        for (auto &[from, to] : chunk) {
+            from = perm[from];
+            to = perm[to];
+        }
+    }
+    return !chunk.empty();
+}
+
+void EdgeStream::writeTo(std::ostream &outputStream) {
+    TextWriter out(outputStream);
+    out << getNumberOfNodes() << ' ' << getNumberOfEdges() << '\n';
+    std::vector<Edge> chunk;
+    while (nextChunk(chunk)) {
+        for (auto [from, to] : chunk) {
+            out << from << ' ' << to << '\n';
+        }
+    }
+}
+
+void EdgeStream::writeBinaryTo(std::ostream &outputStream) {
+    std::vector<char> buffer;
+    auto put = [&buffer](std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            buffer.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    };
+    put(getNumberOfNodes());
+    put(getNumberOfEdges());
+    std::vector<Edge> chunk;
+    while (nextChunk(chunk)) {
+        for (auto [from, to] : chunk) {
+            put(from);
+            put(to);
+        }
+        outputStream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    outputStream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+namespace {
+
+// trivially copyable, unlike std::pair, so it can be spilled as raw bytes
+struct NodePair {
+    NodeId first;
+    NodeId second;
+
+    auto operator<=>(const NodePair &) const = default;
+};
+
+// Sequential lookups perm[v] for non-decreasing v in a permutation spilled to a temporary file.
+class PermutationScan {
+public:
+    explicit PermutationScan(TemporaryFile &file) : file(file), block(1 << 16) {
+        file.rewind();
+    }
+
+    NodeId operator[](std::uint64_t node) {
+        while (node >= blockEnd) {
+            blockStart = blockEnd;
+            blockEnd += file.read(block.data(), block.size() * sizeof(NodeId)) / sizeof(NodeId);
+            assert(blockEnd > blockStart);
+        }
+        return block[node - blockStart];
+    }
+
+private:
+    TemporaryFile &file;
+    std::vector<NodeId> block;
+    std::uint64_t blockStart = 0;
+    std::uint64_t blockEnd = 0;
+};
+
+}  // namespace
+
+template <typename F>
+void EdgeStream::forEachSortedEdge(const ExternalSortOptions &options, F &&f) {
+    ExternalSortOptions half = options;
+    half.memoryBudget = std::max<std::size_t>(options.memoryBudget / 2, 1);
+
+    // The chunks come in original labels once the permutation is taken out of the stream.
+    std::vector<NodeId> permutation = std::move(perm);
+    perm = {};
+    std::unique_ptr<TemporaryFile> permutationFile;
+    if (!permutation.empty()) {
+        permutationFile = std::make_unique<TemporaryFile>(options.temporaryDirectory);
+        permutationFile->write(permutation.data(), permutation.size() * sizeof(NodeId));
+        std::vector<NodeId>().swap(permutation);
+    }
+
+    ExternalSorter<NodePair> bySource(half);
+    std::vector<Edge> chunk;
+    while (nextChunk(chunk)) {
+        for (auto [from, to] : chunk) {
+            bySource.push({static_cast<NodeId>(from), static_cast<NodeId>(to)});
+        }
+    }
+    if (!permutationFile) {
+        bySource.drain([&](const NodePair &edge) { f(edge.first, edge.second); });
+        return;
+    }
+
+    // (target, relabeled source), then (relabeled source, relabeled target)
+    ExternalSorter<NodePair> byTarget(half);
+    {
+        PermutationScan scan(*permutationFile);
+        bySource.drain([&](const NodePair &edge) { byTarget.push({edge.second, scan[edge.first]}); });
+    }
+    ExternalSorter<NodePair> relabeled(half);
+    {
+        PermutationScan scan(*permutationFile);
+        byTarget.drain([&](const NodePair &edge) { relabeled.push({edge.second, scan[edge.first]}); });
+    }
+    permutationFile.reset();
+    relabeled.drain([&](const NodePair &edge) { f(edge.first, edge.second); });
+}
+
+void EdgeStream::writeSortedTo(std::ostream &outputStream, bool binary, const ExternalSortOptions &options) {
+    TESTFRAME_SCOPED_TIMER("EdgeStream::writeSortedTo");
+    if (!binary) {
+        TextWriter out(outputStream);
+        out << getNumberOfNodes() << ' ' << getNumberOfEdges() << '\n';
+        forEachSortedEdge(options, [&](std::uint64_t from, std::uint64_t to) {
+            out << from << ' ' << to << '\n';
+        });
+        return;
+    }
+    std::vector<char> buffer;
+    auto put = [&buffer](std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            buffer.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    };
+    put(getNumberOfNodes());
+    put(getNumberOfEdges());
+    forEachSortedEdge(options, [&](std::uint64_t from, std::uint64_t to) {
+        put(from);
+        put(to);
+        if (buffer.size() >= (1 << 20)) {
+            outputStream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    });
+    outputStream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+Graph EdgeStream::toGraph() {
+    std::vector<std::vector<NodeId>> g(getNumberOfNodes());
+    for (auto [from, to] : *this) {
+        g[from].push_back(to);
+    }
+    return Graph(std::move(g), directed);
+}
+
+namespace {
+
+using Edge = EdgeStream::Edge;
+
+bool chunkFull(const std::vector<Edge> &chunk) {
+    return chunk.size() >= EdgeStream::defaultChunkSize;
+}
+
+void emitUndirected(std::vector<Edge> &chunk, std::uint64_t u, std::uint64_t v) {
+    chunk.emplace_back(u, v);
+    chunk.emplace_back(v, u);
+}
+
+// Yields `count` distinct undirected pairs (i < j) of [0, nodes) uniformly, in lexicographic order.
+EdgeStream::Producer uniformPairs(std::uint64_t nodes, std::uint64_t count) {
+    return [sampler = SortedSampler(rnd, count, nodes * (nodes - 1) / 2), row = std::uint64_t{0},
+            rowStart = std::uint64_t{0}, nodes](std::vector<Edge> &chunk) mutable {
+        while (sampler.hasNext() && !chunkFull(chunk)) {
+            std::uint64_t index = sampler.next();
+            while (index >= rowStart + (nodes - 1 - row)) {
+                rowStart += nodes - 1 - row;
+                ++row;
+            }
+            emitUndirected(chunk, row, row + 1 + (index - rowStart));
+        }
+        return sampler.hasNext();
+    };
+}
+
+// Prüfer decoding into a tree on [first, first + size), linear time with the "smallest leaf pointer" technique.
+void appendPruferTree(std::vector<Edge> &out, std::uint64_t first, std::uint64_t size) {
+    if (size == 2) {
+        out.emplace_back(first, first + 1);
+        return;
+    }
+    std::vector<std::uint64_t> prufer(size - 2), degree(size, 1);
+    for (auto &x : prufer) {
+        x = rnd.intFromRange(size - 1);
+        ++degree[x];
+    }
+    std::uint64_t pointer = 0;
+    while (degree[pointer] != 1) {
+        ++pointer;
+    }
+    std::uint64_t leaf = pointer;
+    for (auto v : prufer) {
+        out.emplace_back(first + leaf, first + v);
+        if (--degree[v] == 1 && v < pointer) {
+            leaf = v;
+        } else {
+            ++pointer;
+            while (degree[pointer] != 1) {
+                ++pointer;
+            }
+            leaf = pointer;
+        }
+    }
+    out.emplace_back(first + leaf, first + size - 1);
+}
+
+}  // namespace
+
+EdgeStream EdgeStream::constructEmptyGraph(std::uint64_t nodes) {
+    return EdgeStream(nodes, 0, false, nullptr);
+}
+
+EdgeStream EdgeStream::constructUndirectedClique(std::uint64_t nodes) {
+    return EdgeStream(nodes, nodes * (nodes - 1), false,
+                      [i = std::uint64_t{0}, j = std::uint64_t{1}, nodes](std::vector<Edge> &chunk) mutable {
+                          while (i + 1 < nodes && !chunkFull(chunk)) {
+                              emitUndirected(chunk, i, j);
+                              if (++j == nodes) {
+                                  ++i;
+                                  j = i + 1;
+                              }
+                          }
+                          return i + 1 < nodes;
+                      });
+}
+
+EdgeStream EdgeStream::constructPathGraph(std::uint64_t nodes, std::uint64_t numberOfComponents) {
+    std::vector part = rnd.partition(numberOfComponents, nodes);
+    return EdgeStream(nodes, 2 * (nodes - numberOfComponents), false,
+                      [part, l = std::size_t{0}, i = std::uint64_t{0}, current = std::uint64_t{0}](
+                          std::vector<Edge> &chunk) mutable {
+                          while (l < part.size() && !chunkFull(chunk)) {
+                              if (i + 1 < static_cast<std::uint64_t>(part[l])) {
+                                  emitUndirected(chunk, current, current + 1);
+                                  ++current;
+                                  ++i;
+                              } else {
+                                  ++current;
+                                  ++l;
+                                  i = 0;
+                              }
+                          }
+                          return l < part.size();
+                      });
+}
+
+EdgeStream EdgeStream::constructShallowForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees) {
+    std::vector pa = rnd.partition(numberOfTrees, nodes);
+    return EdgeStream(nodes, 2 * (nodes - numberOfTrees), false,
+                      [pa, nodes, i = std::uint64_t{0}, root = std::uint64_t{0}, sum = std::uint64_t{0},
+                       pnt = std::size_t{0}](std::vector<Edge> &chunk) mutable {
+                          for (; i < nodes && !chunkFull(chunk); ++i) {
+                              if (i == sum) {
+                                  root = sum;
+                                  sum += pa[pnt++];
+                                  continue;
+                              }
+                              emitUndirected(chunk, rnd.intFromRange(root, i - 1), i);
+                          }
+                          return i < nodes;
+                      });
+}
+
+EdgeStream EdgeStream::constructShallowTreeGraph(std::uint64_t nodes) {
+    return constructShallowForestGraph(nodes, 1);
+}
+
+EdgeStream EdgeStream::constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees) {
+    std::vector pa = rnd.partition(numberOfTrees, nodes);
+    return EdgeStream(nodes, 2 * (nodes - numberOfTrees), false,
+                      [pa, tree = std::size_t{0}, first = std::uint64_t{0}, pending = std::vector<Edge>{},
+                       next = std::size_t{0}](std::vector<Edge> &chunk) mutable {
+                          while (!chunkFull(chunk)) {
+                              if (next == pending.size()) {
+                                  if (tree == pa.size()) {
+                                      return false;
+                                  }
+                                  pending.clear();
+                                  next = 0;
+                                  std::uint64_t size = pa[tree++];
+                                  if (size >= 2) {
+                                      appendPruferTree(pending, first, size);
+                                  }
+                                  first += size;
+                                  continue;
+                              }
+                              emitUndirected(chunk, pending[next].first, pending[next].second);
+                              ++next;
+                          }
+                          return true;
+                      });
+}
+
+EdgeStream EdgeStream::constructTreeGraph(std::uint64_t nodes) {
+    return constructForestGraph(nodes, 1);
+}
+
+EdgeStream EdgeStream::constructSimplerJellyfishGraph(std::uint64_t nodes, std::uint64_t cycleSize,
+                                                      std::uint64_t minTentacleLength, std::uint64_t numberOfTentacles) {
+    std::vector pa = rnd.partition(numberOfTentacles, nodes - cycleSize, minTentacleLength);
+    // Cycles of 1 or 2 nodes are not closed, that would add a self-loop or repeat an edge.
+    return EdgeStream(nodes, 2 * (cycleSize >= 3 ? nodes : nodes - 1), false,
+                      [pa, cycleSize, i = std::uint64_t{0}, ray = std::size_t{0}, prev = std::uint64_t{0},
+                       next = std::uint64_t{1}](std::vector<Edge> &chunk) mutable {
+                          while (!chunkFull(chunk)) {
+                              if (i + 1 < cycleSize) {
+                                  emitUndirected(chunk, prev, next);
+                                  prev = next++;
+                                  ++i;
+                              } else if (i + 1 == cycleSize) {
+                                  if (cycleSize >= 3) {
+                                      emitUndirected(chunk, prev, 0);
+                                  }
+                                  ++i;
+                              } else if (ray < pa.size()) {
+                                  if (i == cycleSize) {
+                                      prev = cycleSize > 1 ? rnd.intFromRange(cycleSize - 1) : 0;
+                                  }
+                                  if (i - cycleSize < static_cast<std::uint64_t>(pa[ray])) {
+                                      emitUndirected(chunk, prev, next);
+                                      prev = next++;
+                                      ++i;
+                                  }
+                                  if (i - cycleSize == static_cast<std::uint64_t>(pa[ray])) {
+                                      i = cycleSize;
+                                      ++ray;
+                                  }
+                              } else {
+                                  return false;
+                              }
+                          }
+                          return true;
+                      });
+}
+
+EdgeStream EdgeStream::constructStarfishGraph(std::uint64_t nodes, std::uint64_t minRayLength,
+                                              std::uint64_t numberOfRays) {
+    return constructSimplerJellyfishGraph(nodes, 1, minRayLength, numberOfRays);
+}
+
+EdgeStream EdgeStream::constructSilkwormGraph(std::uint64_t nodes) {
+    return EdgeStream(nodes, nodes > 0 ? 2 * (nodes - 1) : 0, false,
+                      [nodes, i = std::uint64_t{0}](std::vector<Edge> &chunk) mutable {
+                          for (; i < nodes && !chunkFull(chunk); i += 2) {
+                              if (i + 1 < nodes) {
+                                  emitUndirected(chunk, i, i + 1);
+                              }
+                              if (i + 2 < nodes) {
+                                  emitUndirected(chunk, i, i + 2);
+                              }
+                          }
+                          return i < nodes;
+                      });
+}
+
+// Requires `minDegree >= 1`, otherwise the number of edges is not known before generation.
+EdgeStream EdgeStream::constructTreeOfBoundedDegreeGraph(std::uint64_t nodes, std::uint64_t minDegree,
+                                                         std::uint64_t maxDegree) {
+    assert(minDegree >= 1 || nodes <= 1);
+    // Nodes enter the tree in id order, so the BFS queue of `Graph` is always the id range [current, next).
+    return EdgeStream(nodes, nodes > 0 ? 2 * (nodes - 1) : 0, false,
+                      [nodes, minDegree, maxDegree, current = std::uint64_t{0}, next = std::uint64_t{1},
+                       degree = std::uint64_t{0}](std::vector<Edge> &chunk) mutable {
+                          while (!chunkFull(chunk)) {
+                              if (degree == 0) {
+                                  if (next >= nodes || current >= next) {
+                                      return false;
+                                  }
+                                  std::uint64_t available = nodes - next;
+                                  degree = rnd.intFromRange(std::min(minDegree, available),
+                                                            std::min(maxDegree, available));
+                                  ++current;
+                                  continue;
+                              }
+                              emitUndirected(chunk, current - 1, next++);
+                              --degree;
+                          }
+                          return true;
+                      });
+}
+
+EdgeStream EdgeStream::constructSparseGraph(std::uint64_t nodes) {
+    std::uint64_t numberOfEdges = rnd.intFromRange(nodes * static_cast<std::uint64_t>(std::sqrt(nodes)) / 2);
+    return EdgeStream(nodes, 2 * numberOfEdges, false, uniformPairs(nodes, numberOfEdges));
+}
+
+EdgeStream EdgeStream::constructDenseGraph(std::uint64_t nodes) {
+    std::uint64_t numberOfEdges = rnd.intFromRange(nodes * static_cast<std::uint64_t>(std::sqrt(nodes)) / 2,
+                                                   nodes * (nodes - 1) / 2);
+    return EdgeStream(nodes, 2 * numberOfEdges, false, uniformPairs(nodes, numberOfEdges));
+}
+
+EdgeStream EdgeStream::constructRandomDAG(std::uint64_t nodes, std::uint64_t edges, std::uint64_t height) {
+    auto sizes = rnd.partition(height, nodes, 1);
+    return constructRandomDAG(std::vector<std::uint64_t>(sizes.begin(), sizes.end()), edges);
+}
+
+EdgeStream EdgeStream::constructRandomDAG(const std::vector<std::uint64_t> &layerSizes, std::uint64_t edges) {
+    DagLayout layout(layerSizes);
+    assert(edges <= layout.getNumberOfPairs());
+    std::uint64_t nodes = layout.getNumberOfNodes();
+    SortedSampler sampler(rnd, edges, layout.getNumberOfPairs());
+    return EdgeStream(nodes, edges, true,
+                      [layout = std::move(layout), sampler, layer = std::size_t{0}](std::vector<Edge> &chunk) mutable {
+                          while (sampler.hasNext() && !chunkFull(chunk)) {
+                              auto [from, to] = layout.decode(sampler.next(), layer);
+                              chunk.emplace_back(from, to);
+                          }
+                          return sampler.hasNext();
+                      });
+}
+
+EdgeStream EdgeStream::constructBipartiteGraph(std::uint64_t leftNodes, std::uint64_t rightNodes, double probability) {
+    assert(0. <= probability && probability <= 1.);
+    // The number of present pairs is binomial and, given it, the set of pairs is uniform, so this matches
+    // `Graph::constructBipartiteGraph` in distribution without knowing the edges in advance.
+    std::binomial_distribution<std::uint64_t> numberOfPairs(leftNodes * rightNodes, probability);
+    std::uint64_t count = numberOfPairs(rnd.engine);
+    return EdgeStream(leftNodes + rightNodes, 2 * count, false,
+                      [sampler = SortedSampler(rnd, count, leftNodes * rightNodes), leftNodes,
+                       rightNodes](std::vector<Edge> &chunk) mutable {
+                          while (sampler.hasNext() && !chunkFull(chunk)) {
+                              std::uint64_t index = sampler.next();
+                              emitUndirected(chunk, index / rightNodes, leftNodes + index % rightNodes);
+                          }
+                          return sampler.hasNext();
+                      });
+}
+
+EdgeStream EdgeStream::constructBicliqueGraph(std::uint64_t leftNodes, std::uint64_t rightNodes) {
+    const std::uint64_t pairs = leftNodes * rightNodes;
+    return EdgeStream(leftNodes + rightNodes, 2 * pairs, false,
+                      [leftNodes, rightNodes, pairs, index = std::uint64_t{0}](std::vector<Edge> &chunk) mutable {
+                          for (; index < pairs && !chunkFull(chunk); ++index) {
+                              emitUndirected(chunk, index / rightNodes, leftNodes + index % rightNodes);
+                          }
+                          return index < pairs;
+                      });
+}
+
+namespace {
+
+EdgeStream gridStream(std::uint64_t rows, std::uint64_t columns, bool wrap) {
+    assert(rows > 0 && columns > 0);
+    GridLayout layout(rows, columns, wrap);
+    return EdgeStream(layout.getNumberOfNodes(), layout.getNumberOfEdges(), false,
+                      [layout, u = std::uint64_t{0}](std::vector<Edge> &chunk) mutable {
+                          for (; u < layout.getNumberOfNodes() && !chunkFull(chunk); ++u) {
+                              layout.forEachNeighbor(u, [&](std::uint64_t v) {
+                                  if (u < v) {
+                                      emitUndirected(chunk, u, v);
+                                  }
+                              });
+                          }
+                          return u < layout.getNumberOfNodes();
+                      });
+}
+
+}  // namespace
+
+EdgeStream EdgeStream::constructLatticeGraph(std::uint64_t rows, std::uint64_t columns) {
+    return gridStream(rows, columns, true);
+}
+
+EdgeStream EdgeStream::constructGridGraph(std::uint64_t rows, std::uint64_t columns) {
+    return gridStream(rows, columns, false);
+}
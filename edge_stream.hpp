@@ -0,0 +1,150 @@
+#ifndef EDGE_STREAM_H_
+#define EDGE_STREAM_H_
+
+#include "external_sort.hpp"
+#include "graph.hpp"
+#include <iterator>
+
+/**
+ * @brief Lazy, chunked stream of the edges of a generated graph.
+ *
+ * The `construct*` factories mirror the ones of `Graph` and produce the same families of graphs, but edges are
+ * generated on demand, one chunk at a time, and relabeled on the fly with a permutation drawn up front. Memory use is
+ * O(nodes + chunk size) at most, independent of the number of edges, so huge tests can be written straight to a file.
+ *
+ * Undirected edges are yielded as two consecutive adjacency entries (u, v) and (v, u), exactly like `Graph::getEdges`
+ * lists them, so `getNumberOfEdges` and the printed edge multiset agree with the materialized graph.
+ *
+ * @note Streams draw from `rnd` lazily, interleaving other uses of `rnd` changes the generated edges.
+ */
+class EdgeStream {
+public:
+    using Edge = std::pair<std::uint64_t, std::uint64_t>;
+    // Appends the next edges (in original labels) to the chunk, returns false once there is nothing left.
+    using Producer = std::function<bool(std::vector<Edge> &chunk)>;
+
+    static constexpr std::size_t defaultChunkSize = 1 << 16;
+
+    bool directed = false;
+
+    EdgeStream(std::uint64_t nodes, std::uint64_t edges, bool directed, Producer producer, bool relabel = true);
+
+    std::uint64_t getNumberOfNodes() const {
+        return nodes;
+    }
+
+    // number of adjacency entries the stream yields in total
+    std::uint64_t getNumberOfEdges() const {
+        return edges;
+    }
+
+    // Replaces `chunk` with the next relabeled edges, returns false when the stream is exhausted.
+    bool nextChunk(std::vector<Edge> &chunk);
+
+    class iterator {
+    public:
+        using value_type = Edge;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(EdgeStream *stream) : stream(stream) {
+            advanceChunk();
+        }
+
+        const Edge &operator*() const {
+            return chunk[index];
+        }
+
+        iterator &operator++() {
+            if (++index == chunk.size()) {
+                advanceChunk();
+            }
+            return *this;
+        }
+
+        void operator++(int) {
+            ++*this;
+        }
+
+        bool operator==(std::default_sentinel_t) const {
+            return stream == nullptr;
+        }
+
+    private:
+        void advanceChunk() {
+            index = 0;
+            while (stream != nullptr && (!stream->nextChunk(chunk) || chunk.empty())) {
+                if (chunk.empty()) {
+                    stream = nullptr;
+                }
+            }
+        }
+
+        EdgeStream *stream = nullptr;
+        std::vector<Edge> chunk;
+        std::size_t index = 0;
+    };
+
+    // single-pass range over the remaining edges
+    iterator begin() {
+        return iterator(this);
+    }
+
+    std::default_sentinel_t end() {
+        return std::default_sentinel;
+    }
+
+    // Writes the remaining edges in the format of `Graph::PrintFormat::SolutionAdjecencyList`.
+    void writeTo(std::ostream &outputStream);
+
+    // Writes little-endian 64-bit words: nodes, edges, then `from to` for every edge.
+    void writeBinaryTo(std::ostream &outputStream);
+
+    /**
+     * @brief Writes the remaining edges in adjacency order, sorted by source and then by target, in the format of
+     * `writeTo` (or `writeBinaryTo` if `binary`), for tests with more edges than fit in memory.
+     *
+     * The edges are the same as the ones `writeTo` prints. They are sorted out of core with `ExternalSorter`, two
+     * sorters at a time holding `options.memoryBudget` bytes together. Relabeling is done as external join passes:
+     * the permutation is spilled to disk, the edges are sorted by source and relabeled while scanning it, then sorted
+     * by target and relabeled in a second scan.
+     */
+    void writeSortedTo(std::ostream &outputStream, bool binary = false, const ExternalSortOptions &options = {});
+
+    // Materializes the remaining edges, mostly useful for checking small streams against `Graph`.
+    Graph toGraph();
+
+    static EdgeStream constructEmptyGraph(std::uint64_t nodes);
+    static EdgeStream constructUndirectedClique(std::uint64_t nodes);
+    static EdgeStream constructPathGraph(std::uint64_t nodes, std::uint64_t numberOfComponents = 1);
+    static EdgeStream constructShallowForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees);
+    static EdgeStream constructShallowTreeGraph(std::uint64_t nodes);
+    static EdgeStream constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees);
+    static EdgeStream constructTreeGraph(std::uint64_t nodes);
+    static EdgeStream constructSimplerJellyfishGraph(std::uint64_t nodes, std::uint64_t cycleSize,
+                                                     std::uint64_t minTentacleLength, std::uint64_t numberOfTentacles);
+    static EdgeStream constructStarfishGraph(std::uint64_t nodes, std::uint64_t minRayLength, std::uint64_t numberOfRays);
+    static EdgeStream constructSilkwormGraph(std::uint64_t nodes);
+    static EdgeStream constructTreeOfBoundedDegreeGraph(std::uint64_t nodes, std::uint64_t minDegree,
+                                                        std::uint64_t maxDegree);
+    static EdgeStream constructSparseGraph(std::uint64_t nodes);
+    static EdgeStream constructDenseGraph(std::uint64_t nodes);
+    static EdgeStream constructRandomDAG(std::uint64_t nodes, std::uint64_t edges, std::uint64_t height);
+    static EdgeStream constructRandomDAG(const std::vector<std::uint64_t> &layerSizes, std::uint64_t edges);
+    static EdgeStream constructBipartiteGraph(std::uint64_t leftNodes, std::uint64_t rightNodes, double probability);
+    static EdgeStream constructBicliqueGraph(std::uint64_t leftNodes, std::uint64_t rightNodes);
+    static EdgeStream constructLatticeGraph(std::uint64_t rows, std::uint64_t columns);
+    static EdgeStream constructGridGraph(std::uint64_t rows, std::uint64_t columns);
+
+private:
+    // Calls `f(from, to)` for the remaining relabeled edges in sorted order.
+    template <typename F>
+    void forEachSortedEdge(const ExternalSortOptions &options, F &&f);
+
+    std::uint64_t nodes;
+    std::uint64_t edges;
+    Producer producer;
+    std::vector<NodeId> perm;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "external_sort.hpp"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+TemporaryFile::TemporaryFile(const std::filesystem::path &directory) {
+    static std::atomic<std::uint64_t> counter = 0;
+    path = directory / ("testframe-" + std::to_string(::getpid()) + "-" + std::to_string(counter++) + ".tmp");
+    file.open(path, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: Could not create the temporary file " << path.string() << std::endl;
+        exit(1);
+    }
+}
+
+TemporaryFile::~TemporaryFile() {
+    file.close();
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+void TemporaryFile::write(const void *data, std::size_t bytes) {
+    if (!file.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes))) {
+        std::cerr << "Error: Could not write the temporary file " << path.string() << std::endl;
+        exit(1);
+    }
+}
+
+void TemporaryFile::rewind() {
+    file.flush();
+    file.clear();
+    file.seekg(0);
+}
+
+std::size_t TemporaryFile::read(void *data, std::size_t bytes) {
+    file.read(static_cast<char *>(data), static_cast<std::streamsize>(bytes));
+    if (file.bad()) {
+        std::cerr << "Error: Could not read the temporary file " << path.string() << std::endl;
+        exit(1);
+    }
+    return static_cast<std::size_t>(file.gcount());
+}
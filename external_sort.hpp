@@ -0,0 +1,220 @@
+#ifndef EXTERNAL_SORT_H_
+#define EXTERNAL_SORT_H_
+
+#include "instrument.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <type_traits>
+#include <vector>
+
+struct ExternalSortOptions {
+    // bytes of records held in memory at once, per sorter
+    std::size_t memoryBudget = std::size_t{1} << 30;
+    // where sorted runs are spilled, they are removed again as soon as they are merged
+    std::filesystem::path temporaryDirectory = std::filesystem::temp_directory_path();
+    // threads sorting each run in memory, 0 uses all hardware threads
+    unsigned threads = 1;
+};
+
+/**
+ * @brief Binary temporary file with a unique name in `directory`, deleted on destruction. I/O errors are reported on
+ * `std::cerr` and end the program.
+ */
+class TemporaryFile {
+public:
+    explicit TemporaryFile(const std::filesystem::path &directory);
+    ~TemporaryFile();
+
+    TemporaryFile(const TemporaryFile &) = delete;
+    TemporaryFile &operator=(const TemporaryFile &) = delete;
+
+    void write(const void *data, std::size_t bytes);
+    // Ends writing and rewinds, `read` then returns the contents from the start.
+    void rewind();
+    // Reads up to `bytes`, returns how many were read, 0 at the end of the file.
+    std::size_t read(void *data, std::size_t bytes);
+
+private:
+    std::filesystem::path path;
+    std::fstream file;
+};
+
+/**
+ * @brief Sorts more records than fit in memory: records are collected into runs of `memoryBudget` bytes, every full
+ * run is sorted and spilled to a temporary file, and `drain` merges all runs with one k-way merge. Runs are merged
+ * early in groups of `maxRuns` runs of the same size class, like a counter in base `maxRuns`, which bounds the number
+ * of open files while every record is merged only O(log_maxRuns(runs)) times.
+ *
+ * If everything fits into a single run nothing touches the disk. Records with equal keys come out in an unspecified
+ * order. The merge reads every run in blocks of `memoryBudget / runs` bytes, e.g. 10^9 edges of 8 bytes make 8 runs
+ * and 128 MiB blocks with the default budget.
+ */
+template <typename T, typename Less = std::less<T>>
+requires std::is_trivially_copyable_v<T>
+class ExternalSorter {
+public:
+    static constexpr std::size_t maxRuns = 64;
+
+    explicit ExternalSorter(const ExternalSortOptions &options = {}, Less less = {})
+        : options(options),
+          less(less),
+          capacity(std::max<std::size_t>(options.memoryBudget / sizeof(T), 1)) {}
+
+    void push(const T &value) {
+        if (buffer.size() == capacity) {
+            spillRun();
+        } else if (buffer.size() == buffer.capacity()) {
+            // grow by doubling, but never past the budget
+            buffer.reserve(std::min(capacity, std::max<std::size_t>(2 * buffer.size(), 1024)));
+        }
+        buffer.push_back(value);
+        ++count;
+    }
+
+    std::uint64_t size() const {
+        return count;
+    }
+
+    // Calls `f(value)` for every record in sorted order and leaves the sorter empty.
+    template <typename F>
+    void drain(F &&f) {
+        TESTFRAME_SCOPED_TIMER("ExternalSorter::drain");
+        if (runs.empty()) {
+            sortBuffer();
+            for (const auto &value : buffer) {
+                f(value);
+            }
+        } else {
+            if (!buffer.empty()) {
+                spillRun();
+            }
+            std::vector<T>().swap(buffer);
+            mergeRuns(0, capacity, f);
+        }
+        buffer.clear();
+        runs.clear();
+        levels.clear();
+        count = 0;
+    }
+
+private:
+    void sortBuffer() {
+        const unsigned threads = resolveThreadCount(options.threads);
+        if (threads == 1 || buffer.size() < (1 << 16)) {
+            std::sort(buffer.begin(), buffer.end(), less);
+            return;
+        }
+        // sorted slices, then pairwise merges of neighbouring slices
+        parallelForChunks(0, buffer.size(), threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+            std::sort(buffer.begin() + from, buffer.begin() + to, less);
+        });
+        const std::size_t slice = (buffer.size() + threads - 1) / threads;
+        for (std::size_t width = (slice + 1023) / 1024 * 1024; width < buffer.size(); width *= 2) {
+            for (std::size_t from = 0; from + width < buffer.size(); from += 2 * width) {
+                std::inplace_merge(buffer.begin() + from, buffer.begin() + from + width,
+                                   buffer.begin() + std::min(buffer.size(), from + 2 * width), less);
+            }
+        }
+    }
+
+    void spillRun() {
+        TESTFRAME_SCOPED_TIMER("ExternalSorter::spillRun");
+        sortBuffer();
+        auto &run = runs.emplace_back(std::make_unique<TemporaryFile>(options.temporaryDirectory));
+        run->write(buffer.data(), buffer.size() * sizeof(T));
+        run->rewind();
+        levels.push_back(0);
+        buffer.clear();
+        while (runs.size() >= maxRuns && levels[runs.size() - maxRuns] == levels.back()) {
+            compactRuns(runs.size() - maxRuns);
+        }
+    }
+
+    // Merges the runs from `first` on into one run of the next level, half of the budget buffers the input and half
+    // the output.
+    void compactRuns(std::size_t first) {
+        TESTFRAME_SCOPED_TIMER("ExternalSorter::compactRuns");
+        std::vector<T>().swap(buffer);
+        auto merged = std::make_unique<TemporaryFile>(options.temporaryDirectory);
+        std::vector<T> output;
+        output.reserve(std::max<std::size_t>(capacity / 2, 1));
+        mergeRuns(first, output.capacity(), [&](const T &value) {
+            output.push_back(value);
+            if (output.size() == output.capacity()) {
+                merged->write(output.data(), output.size() * sizeof(T));
+                output.clear();
+            }
+        });
+        merged->write(output.data(), output.size() * sizeof(T));
+        merged->rewind();
+        const unsigned level = levels.back() + 1;
+        runs.resize(first);
+        levels.resize(first);
+        runs.push_back(std::move(merged));
+        levels.push_back(level);
+    }
+
+    // Merges the runs from `first` on with `records` records of read buffers in total.
+    template <typename F>
+    void mergeRuns(std::size_t first, std::size_t records, F &&f) {
+        struct Reader {
+            TemporaryFile *file;
+            std::vector<T> block;
+            std::size_t position = 0;
+
+            bool refill() {
+                block.resize(block.capacity());
+                const std::size_t bytes = file->read(block.data(), block.size() * sizeof(T));
+                block.resize(bytes / sizeof(T));
+                position = 0;
+                return !block.empty();
+            }
+        };
+        const std::size_t blockSize = std::max<std::size_t>(records / (runs.size() - first), 1);
+        std::vector<Reader> readers(runs.size() - first);
+        for (std::size_t r = 0; r < readers.size(); ++r) {
+            readers[r].file = runs[first + r].get();
+            readers[r].block.reserve(blockSize);
+            readers[r].refill();
+        }
+
+        auto greater = [&](std::size_t a, std::size_t b) {
+            return less(readers[b].block[readers[b].position], readers[a].block[readers[a].position]);
+        };
+        std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> heap(greater);
+        for (std::size_t r = 0; r < readers.size(); ++r) {
+            if (!readers[r].block.empty()) {
+                heap.push(r);
+            }
+        }
+        while (!heap.empty()) {
+            const std::size_t r = heap.top();
+            heap.pop();
+            Reader &reader = readers[r];
+            f(reader.block[reader.position]);
+            if (++reader.position < reader.block.size() || reader.refill()) {
+                heap.push(r);
+            } else {
+                runs[first + r].reset();
+            }
+        }
+    }
+
+    ExternalSortOptions options;
+    Less less;
+    std::size_t capacity;
+    std::vector<T> buffer;
+    std::vector<std::unique_ptr<TemporaryFile>> runs;
+    // merge level of every run, non-increasing
+    std::vector<unsigned> levels;
+    std::uint64_t count = 0;
+};
+
+#endif
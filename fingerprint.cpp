@@ -0,0 +1,193 @@
+#include "fingerprint.hpp"
+#include "csr_graph.hpp"
+#include "dynamic_graph.hpp"
+#include "implicit_graph.hpp"
+#include "parallel.hpp"
+#include "validate.hpp"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+std::uint64_t combine(std::uint64_t seed, std::uint64_t value) {
+    return mix(seed ^ mix(value));
+}
+
+std::uint64_t countColours(std::vector<std::uint64_t> colours) {
+    std::sort(colours.begin(), colours.end());
+    return std::unique(colours.begin(), colours.end()) - colours.begin();
+}
+
+// Colours start from (degree, triangles at the node), which also separates many regular graphs that plain
+// Weisfeiler–Lehman cannot. Refinement stops early once the colour classes stop splitting. The result is the sum of
+// the hashed colours of every round, so it does not depend on the node order.
+template <GraphLike G>
+std::uint64_t refine(const G &graph, const std::vector<std::uint64_t> &localTriangles, unsigned maxRounds,
+                     unsigned threads) {
+    const std::uint64_t n = graph.getNumberOfNodes();
+    std::vector<std::uint64_t> colour(n), next(n), partial(threads, 0);
+    parallelForChunks(0, n, threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+        for (std::uint64_t v = from; v < to; ++v) {
+            colour[v] = combine(mix(graph.getDegree(v)), localTriangles[v]);
+            partial[t] += mix(colour[v]);
+        }
+    });
+    std::uint64_t classes = countColours(colour);
+    for (unsigned round = 1; round <= maxRounds; ++round) {
+        parallelForChunks(0, n, threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+            for (std::uint64_t v = from; v < to; ++v) {
+                // The sum of hashed neighbour colours stands for the neighbour colour multiset.
+                std::uint64_t neighbours = 0;
+                graph.forEachNeighbor(v, [&](std::uint64_t u) {
+                    neighbours += mix(colour[u] ^ round);
+                });
+                next[v] = combine(colour[v], neighbours);
+                partial[t] += mix(next[v] + round);
+            }
+        });
+        std::swap(colour, next);
+        std::uint64_t refined = countColours(colour);
+        if (refined == classes) {
+            break;
+        }
+        classes = refined;
+    }
+    std::uint64_t hash = 0;
+    for (auto p : partial) {
+        hash += p;
+    }
+    return hash;
+}
+
+// Forward algorithm: every edge of the underlying simple graph is kept at the endpoint of lower (degree, id) rank, so
+// every forward list has O(sqrt(m)) entries, and triangles are counted by marking one forward list in a bitset and
+// probing the forward lists of its members.
+template <GraphLike G>
+std::uint64_t countTriangles(const G &graph, std::vector<std::uint64_t> &localTriangles, unsigned threads) {
+    const std::uint64_t n = graph.getNumberOfNodes();
+    auto before = [&](std::uint64_t u, std::uint64_t v) {
+        std::uint64_t du = graph.getDegree(u), dv = graph.getDegree(v);
+        return du != dv ? du < dv : u < v;
+    };
+
+    std::vector<std::uint64_t> offsets(n + 1, 0);
+    for (std::uint64_t u = 0; u < n; ++u) {
+        graph.forEachNeighbor(u, [&](std::uint64_t v) {
+            if (u != v) {
+                ++offsets[(before(u, v) ? u : v) + 1];
+            }
+        });
+    }
+    for (std::uint64_t u = 0; u < n; ++u) {
+        offsets[u + 1] += offsets[u];
+    }
+    std::vector<std::uint64_t> forward(offsets.back()), position(offsets.begin(), offsets.end() - 1);
+    for (std::uint64_t u = 0; u < n; ++u) {
+        graph.forEachNeighbor(u, [&](std::uint64_t v) {
+            if (u != v) {
+                auto [low, high] = before(u, v) ? std::pair(u, v) : std::pair(v, u);
+                forward[position[low]++] = high;
+            }
+        });
+    }
+    // Undirected edges arrive from both endpoints and multi-edges repeat, keep every pair once.
+    std::vector<std::uint64_t> length(n);
+    parallelForChunks(0, n, threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+        for (std::uint64_t u = from; u < to; ++u) {
+            auto first = forward.begin() + offsets[u], last = forward.begin() + offsets[u + 1];
+            std::sort(first, last);
+            length[u] = std::unique(first, last) - first;
+        }
+    });
+
+    std::vector<std::atomic<std::uint64_t>> atNode(n);
+    std::vector<std::uint64_t> partial(threads, 0);
+    parallelForChunks(0, n, threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+        std::vector<bool> marked(n, false);
+        for (std::uint64_t u = from; u < to; ++u) {
+            const std::uint64_t *list = forward.data() + offsets[u];
+            for (std::uint64_t i = 0; i < length[u]; ++i) {
+                marked[list[i]] = true;
+            }
+            for (std::uint64_t i = 0; i < length[u]; ++i) {
+                const std::uint64_t *next = forward.data() + offsets[list[i]];
+                std::uint64_t found = 0;
+                for (std::uint64_t j = 0; j < length[list[i]]; ++j) {
+                    if (marked[next[j]]) {
+                        ++found;
+                        atNode[next[j]].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                if (found > 0) {
+                    atNode[u].fetch_add(found, std::memory_order_relaxed);
+                    atNode[list[i]].fetch_add(found, std::memory_order_relaxed);
+                    partial[t] += found;
+                }
+            }
+            for (std::uint64_t i = 0; i < length[u]; ++i) {
+                marked[list[i]] = false;
+            }
+        }
+    }, 256);
+    localTriangles.resize(n);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        localTriangles[v] = atNode[v].load(std::memory_order_relaxed);
+    }
+    std::uint64_t triangles = 0;
+    for (auto p : partial) {
+        triangles += p;
+    }
+    return triangles;
+}
+
+}  // namespace
+
+std::uint64_t GraphFingerprint::getInvariantsHash() const {
+    std::uint64_t hash = combine(directed, numberOfNodes);
+    hash = combine(hash, numberOfEdges);
+    hash = combine(hash, triangles);
+    hash = combine(hash, degreeHash);
+    return combine(hash, componentHash);
+}
+
+std::uint64_t GraphFingerprint::getHash() const {
+    return combine(getInvariantsHash(), refinementHash);
+}
+
+template <GraphLike G>
+GraphFingerprint computeFingerprint(const G &graph, unsigned maxRounds, unsigned threads) {
+    threads = resolveThreadCount(threads);
+    GraphProperties properties = computeGraphProperties(graph, threads);
+
+    GraphFingerprint fingerprint;
+    fingerprint.directed = graph.directed;
+    fingerprint.numberOfNodes = properties.numberOfNodes;
+    fingerprint.numberOfEdges = properties.numberOfEdges;
+    for (std::uint64_t d = 0; d < properties.degreeHistogram.size(); ++d) {
+        if (properties.degreeHistogram[d] > 0) {
+            fingerprint.degreeHash = combine(combine(fingerprint.degreeHash, d), properties.degreeHistogram[d]);
+        }
+    }
+    for (auto size : properties.componentSizes) {
+        fingerprint.componentHash = combine(fingerprint.componentHash, size);
+    }
+    std::vector<std::uint64_t> localTriangles;
+    fingerprint.triangles = countTriangles(graph, localTriangles, threads);
+    fingerprint.refinementHash = refine(graph, localTriangles, maxRounds, threads);
+    return fingerprint;
+}
+
+template GraphFingerprint computeFingerprint(const Graph &, unsigned, unsigned);
+template GraphFingerprint computeFingerprint(const CsrGraph &, unsigned, unsigned);
+template GraphFingerprint computeFingerprint(const DynamicGraph &, unsigned, unsigned);
+template GraphFingerprint computeFingerprint(const ImplicitClique &, unsigned, unsigned);
+template GraphFingerprint computeFingerprint(const ImplicitPath &, unsigned, unsigned);
+template GraphFingerprint computeFingerprint(const ImplicitSilkworm &, unsigned, unsigned);
+template GraphFingerprint computeFingerprint(const ImplicitStarfish &, unsigned, unsigned);
@@ -0,0 +1,87 @@
+#ifndef FINGERPRINT_H_
+#define FINGERPRINT_H_
+
+#include "graph_view.hpp"
+#include <cstdint>
+#include <unordered_set>
+
+/**
+ * @brief Isomorphism-invariant summary of a graph, equal for any two relabelings of the same graph.
+ *
+ * Different fingerprints prove that two graphs are not isomorphic. Equal fingerprints almost always mean that they are
+ * isomorphic; the exceptions are mostly regular graphs with the same number of triangles at every node, which
+ * Weisfeiler–Lehman refinement cannot tell apart.
+ */
+struct GraphFingerprint {
+    bool directed = false;
+    std::uint64_t numberOfNodes = 0;
+    // number of adjacency entries
+    std::uint64_t numberOfEdges = 0;
+    // triangles of the underlying simple undirected graph
+    std::uint64_t triangles = 0;
+    // hashes of the degree multiset and of the component size multiset
+    std::uint64_t degreeHash = 0;
+    std::uint64_t componentHash = 0;
+    // hash of the multiset of Weisfeiler–Lehman colours after every refinement round
+    std::uint64_t refinementHash = 0;
+
+    // hash of everything except `refinementHash`
+    std::uint64_t getInvariantsHash() const;
+    std::uint64_t getHash() const;
+
+    bool operator==(const GraphFingerprint &other) const = default;
+};
+
+/**
+ * @brief Computes the fingerprint of `graph` in O(rounds * (m + n log n)) for the refinement plus O(m * sqrt(m)) for
+ * triangles, parallel over nodes.
+ *
+ * Refinement stops as soon as no colour class splits, trees for instance need about as many rounds as their radius to
+ * be told apart. Directed graphs are refined along edge direction. Instantiated for `Graph`, `CsrGraph`,
+ * `DynamicGraph` and the implicit views of `implicit_graph.hpp`.
+ *
+ * @param maxRounds upper bound on the number of Weisfeiler–Lehman refinement rounds
+ * @param threads number of worker threads, 0 uses all hardware threads
+ */
+template <GraphLike G>
+GraphFingerprint computeFingerprint(const G &graph, unsigned maxRounds = 16, unsigned threads = 0);
+
+/**
+ * @brief Remembers the fingerprints of the tests of a suite and rejects duplicates.
+ *
+ * @code
+ * TestDeduplicator seen;
+ * while (tests < 100) {
+ *     Graph g = Graph::constructTreeGraph(10);
+ *     if (seen.insert(computeFingerprint(g))) {
+ *         // print test number `++tests`
+ *     }
+ * }
+ * @endcode
+ */
+class TestDeduplicator {
+public:
+    enum class Mode {
+        // rejects graphs that are isomorphic to an earlier one (with high probability)
+        Isomorphic,
+        // also rejects graphs that only share sizes, degrees, components and triangles with an earlier one
+        SameInvariants,
+    };
+
+    explicit TestDeduplicator(Mode mode = Mode::Isomorphic) : mode(mode) {}
+
+    // Returns false if an earlier fingerprint matches, otherwise remembers this one and returns true.
+    bool insert(const GraphFingerprint &fingerprint) {
+        return seen.insert(mode == Mode::Isomorphic ? fingerprint.getHash() : fingerprint.getInvariantsHash()).second;
+    }
+
+    std::uint64_t size() const {
+        return seen.size();
+    }
+
+private:
+    Mode mode;
+    std::unordered_set<std::uint64_t> seen;
+};
+
+#endif
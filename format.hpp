@@ -0,0 +1,265 @@
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include "parallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace format {
+
+// "00", "01", ..., "99" back to back, so two digits are produced per division.
+inline constexpr char digitPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+inline unsigned countDigits(std::uint64_t value) {
+    unsigned digits = 1;
+    while (true) {
+        if (value < 10) {
+            return digits;
+        }
+        if (value < 100) {
+            return digits + 1;
+        }
+        if (value < 1000) {
+            return digits + 2;
+        }
+        if (value < 10000) {
+            return digits + 3;
+        }
+        value /= 10000;
+        digits += 4;
+    }
+}
+
+// Writes the decimal digits of `value` at `out` and returns the end, like `std::to_chars` without bounds checks.
+inline char *formatUnsigned(char *out, std::uint64_t value) {
+    char *end = out + countDigits(value);
+    char *position = end;
+    while (value >= 100) {
+        const std::uint64_t pair = value % 100 * 2;
+        value /= 100;
+        *--position = digitPairs[pair + 1];
+        *--position = digitPairs[pair];
+    }
+    if (value >= 10) {
+        *--position = digitPairs[value * 2 + 1];
+        *--position = digitPairs[value * 2];
+    } else {
+        *--position = static_cast<char>('0' + value);
+    }
+    return end;
+}
+
+inline char *formatSigned(char *out, std::int64_t value) {
+    if (value < 0) {
+        *out++ = '-';
+        // negating in unsigned arithmetic is defined for the minimum as well
+        return formatUnsigned(out, 0 - static_cast<std::uint64_t>(value));
+    }
+    return formatUnsigned(out, static_cast<std::uint64_t>(value));
+}
+
+// integers that iostream prints as numbers, character types and bool are printed differently
+template <typename T>
+concept Integer = std::integral<T> && !std::same_as<T, bool> && !std::same_as<T, char> &&
+                  !std::same_as<T, signed char> && !std::same_as<T, unsigned char> && !std::same_as<T, wchar_t> &&
+                  !std::same_as<T, char8_t> && !std::same_as<T, char16_t> && !std::same_as<T, char32_t>;
+
+template <Integer T>
+char *formatInteger(char *out, T value) {
+    if constexpr (std::is_signed_v<T>) {
+        return formatSigned(out, value);
+    } else {
+        return formatUnsigned(out, value);
+    }
+}
+
+}  // namespace format
+
+/**
+ * @brief Buffered text output for the printers: numbers are formatted with the digit-pair kernel above into a local
+ * buffer that goes to the stream in large blocks, bypassing the per-value sentry and locale work of `std::ostream`.
+ *
+ * The output matches `outputStream << value` for streams in their default state; floating point values use the
+ * stream's precision (up to 40 digits) like the default `%g`-style formatting. Whatever is buffered is written on
+ * `flush` and on destruction.
+ */
+class TextWriter {
+public:
+    static constexpr std::size_t defaultCapacity = 1 << 16;
+
+    explicit TextWriter(std::ostream &outputStream, std::size_t capacity = defaultCapacity)
+        : outputStream(outputStream),
+          precision(std::min(static_cast<int>(outputStream.precision()), maxPrecision)),
+          buffer(capacity + maxValueLength) {}
+
+    ~TextWriter() {
+        flush();
+    }
+
+    TextWriter(const TextWriter &) = delete;
+    TextWriter &operator=(const TextWriter &) = delete;
+
+    TextWriter &operator<<(char c) {
+        *position++ = c;
+        flushIfFull();
+        return *this;
+    }
+
+    TextWriter &operator<<(bool value) {
+        return *this << (value ? '1' : '0');
+    }
+
+    TextWriter &operator<<(std::string_view text) {
+        if (text.size() > maxValueLength) {
+            flush();
+            outputStream.write(text.data(), static_cast<std::streamsize>(text.size()));
+            return *this;
+        }
+        std::memcpy(position, text.data(), text.size());
+        position += text.size();
+        flushIfFull();
+        return *this;
+    }
+
+    TextWriter &operator<<(const char *text) {
+        return *this << std::string_view(text);
+    }
+
+    template <format::Integer T>
+    TextWriter &operator<<(T value) {
+        position = format::formatInteger(position, value);
+        flushIfFull();
+        return *this;
+    }
+
+    template <std::floating_point T>
+    TextWriter &operator<<(T value) {
+        position = std::to_chars(position, position + maxValueLength, value, std::chars_format::general, precision).ptr;
+        flushIfFull();
+        return *this;
+    }
+
+    // Writes the values of `range` with `separator` between them, the batch form of the operators above.
+    template <typename R>
+    TextWriter &appendJoined(const R &range, std::string_view separator) {
+        bool first = true;
+        for (const auto &value : range) {
+            if (!first) {
+                *this << separator;
+            }
+            *this << value;
+            first = false;
+        }
+        return *this;
+    }
+
+    void flush() {
+        outputStream.write(buffer.data(), position - buffer.data());
+        position = buffer.data();
+    }
+
+private:
+    // longest text one operator writes into the slack after `capacity`, enough for a %g double with `maxPrecision`
+    // digits
+    static constexpr std::size_t maxValueLength = 64;
+    static constexpr int maxPrecision = 40;
+
+    void flushIfFull() {
+        if (position >= buffer.data() + buffer.size() - maxValueLength) {
+            flush();
+        }
+    }
+
+    std::ostream &outputStream;
+    int precision;
+    std::vector<char> buffer;
+    char *position = buffer.data();
+};
+
+/**
+ * @brief Stream buffer appending to a string, the target of the chunk writers of `printInParallel`.
+ */
+class StringAppendBuffer : public std::streambuf {
+public:
+    explicit StringAppendBuffer(std::string &text) : text(text) {}
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            text.push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char *data, std::streamsize size) override {
+        text.append(data, static_cast<std::size_t>(size));
+        return size;
+    }
+
+private:
+    std::string &text;
+};
+
+/**
+ * @brief Prints items [0, count) with `printItem(out, i)` for a `TextWriter out`, on `threads` threads (0 means all
+ * hardware threads), with exactly the output of the sequential loop.
+ *
+ * Consecutive items are grouped into chunks of about 2^16 units of `weight(i)` + 1, e.g. adjacency entries per node.
+ * Every round formats a few chunks per thread into separate strings in parallel and then writes them in order, so
+ * memory stays at a few MiB per thread for any number of items. Items are never split, so an item heavier than that,
+ * e.g. a node adjacent to most of a large graph, makes a chunk as large as its own text.
+ */
+template <typename WeightFunction, typename PrintItem>
+void printInParallel(std::ostream &outputStream, std::uint64_t count, unsigned threads, WeightFunction &&weight,
+                     PrintItem &&printItem) {
+    threads = resolveThreadCount(threads);
+    if (threads == 1) {
+        TextWriter out(outputStream);
+        for (std::uint64_t i = 0; i < count; ++i) {
+            printItem(out, i);
+        }
+        return;
+    }
+    constexpr std::uint64_t chunkWeight = 1 << 16;
+    const std::size_t chunksPerRound = 4 * threads;
+    std::vector<std::uint64_t> bounds;
+    std::vector<std::string> texts(chunksPerRound);
+    for (std::uint64_t next = 0; next < count;) {
+        bounds.assign(1, next);
+        while (bounds.size() <= chunksPerRound && next < count) {
+            for (std::uint64_t chunk = 0; next < count && chunk < chunkWeight; ++next) {
+                chunk += weight(next) + 1;
+            }
+            bounds.push_back(next);
+        }
+        const std::size_t chunks = bounds.size() - 1;
+        parallelForChunks(0, chunks, threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+            for (std::uint64_t chunk = from; chunk < to; ++chunk) {
+                texts[chunk].clear();
+                StringAppendBuffer buffer(texts[chunk]);
+                std::ostream chunkStream(&buffer);
+                chunkStream.precision(outputStream.precision());
+                TextWriter out(chunkStream);
+                for (std::uint64_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+                    printItem(out, i);
+                }
+            }
+        }, 1);
+        for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+            outputStream.write(texts[chunk].data(), static_cast<std::streamsize>(texts[chunk].size()));
+        }
+    }
+}
+
+#endif
@@ -1,29 +1,77 @@
 #include "gen_utils.hpp"
 #include "utils.hpp"
+#include "instrument.hpp"
+#include "async_file.hpp"
+#ifdef TESTFRAME_COMPRESSION
+#include "compressed_stream.hpp"
+#endif
 
-/**
- * @brief Returns 2 streams: for prompt input files and for solution input files.
- *
- * @note The caller is responsible for closing the file streams using its close() method.
- */
-std::pair<std::ofstream, std::ofstream> setupTest(std::uint64_t testNumber) {
+namespace {
+
+std::pair<std::string, std::string> testPaths(std::uint64_t testNumber, const std::string &extension) {
     std::ostringstream promptStream;
-    promptStream << dirs.at("promptInputDirectory") << "/" << testNumber << ".in";
+    promptStream << dirs.at("promptInputDirectory") << "/" << testNumber << extension;
     std::string promptInPath = promptStream.str();
 
     std::ostringstream solutionStream;
-    solutionStream << dirs.at("solutionInputDirectory") << "/" << testNumber << ".in";
+    solutionStream << dirs.at("solutionInputDirectory") << "/" << testNumber << extension;
     std::string solutionInPath = solutionStream.str();
 
-    std::ofstream promptInFile(promptInPath);
-    if (!promptInFile) {
-        std::cerr << "Error: Could not open the file " << promptInPath << std::endl;
-        exit(1);
-    }
-    std::ofstream solutionInFile(solutionInPath);
-    if (!solutionInFile) {
-        std::cerr << "Error: Could not open the file " << solutionInPath << std::endl;
+    // Previous files may be hard links into a TestCache, so they are replaced instead of truncated.
+    std::filesystem::remove(promptInPath);
+    std::filesystem::remove(solutionInPath);
+    return {promptInPath, solutionInPath};
+}
+
+std::ofstream openTestFile(const std::string &path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Could not open the file " << path << std::endl;
         exit(1);
     }
+    return file;
+}
+
+}  // namespace
+
+/**
+ * @brief Returns 2 streams: for prompt input files and for solution input files.
+ *
+ * @note The caller is responsible for closing the file streams using its close() method.
+ */
+std::pair<std::ofstream, std::ofstream> setupTest(std::uint64_t testNumber) {
+    TESTFRAME_BEGIN_TEST(testNumber);
+    TESTFRAME_SCOPED_TIMER("setupTest");
+    auto [promptInPath, solutionInPath] = testPaths(testNumber, ".in");
+    // removes compressed files left by an earlier run with OutputOptions::compress
+    testPaths(testNumber, ".in.gz");
+    std::ofstream promptInFile = openTestFile(promptInPath);
+    std::ofstream solutionInFile = openTestFile(solutionInPath);
     return {std::move(promptInFile), std::move(solutionInFile)};
 }
+
+std::pair<std::unique_ptr<std::ostream>, std::unique_ptr<std::ostream>> setupTest(std::uint64_t testNumber,
+                                                                                  const OutputOptions &options) {
+    TESTFRAME_BEGIN_TEST(testNumber);
+    TESTFRAME_SCOPED_TIMER("setupTest");
+    // A test switching between plain and compressed output must not leave the other file behind.
+    auto [promptInPath, solutionInPath] = testPaths(testNumber, ".in");
+    auto [promptGzPath, solutionGzPath] = testPaths(testNumber, ".in.gz");
+    auto open = [&](const std::string &path) -> std::unique_ptr<std::ostream> {
+        if (options.asyncWrite) {
+            return std::make_unique<AsyncOutputFile>(path, AsyncFileOptions{.directIo = options.directIo,
+                                                                            .preallocate = options.preallocate});
+        }
+        return std::make_unique<std::ofstream>(openTestFile(path));
+    };
+    if (!options.compress) {
+        return {open(promptInPath), open(solutionInPath)};
+    }
+#ifdef TESTFRAME_COMPRESSION
+    return {std::make_unique<GzipOutputFile>(open(promptGzPath), options.level, options.threads),
+            std::make_unique<GzipOutputFile>(open(solutionGzPath), options.level, options.threads)};
+#else
+    std::cerr << "Error: Compressed output needs testframe built with zlib" << std::endl;
+    exit(1);
+#endif
+}
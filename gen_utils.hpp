@@ -3,6 +3,7 @@
 
 #include <fstream>
 #include <cstdint>
+#include <memory>
 
 /**
  * @brief Returns 2 streams: for prompt input files and for solution input files.
@@ -11,4 +12,26 @@
  */
 std::pair<std::ofstream, std::ofstream> setupTest(std::uint64_t testNumber);
 
+struct OutputOptions {
+    // gzip both files and name them `<testNumber>.in.gz`, needs a build with zlib, see `compressed_stream.hpp`
+    bool compress = false;
+    // zlib level from 1 (fastest) to 9 (smallest)
+    int level = 6;
+    // compression threads per file, 0 uses all hardware threads
+    unsigned threads = 1;
+    // write from a background thread while the next buffer is formatted, see `async_file.hpp`
+    bool asyncWrite = false;
+    // with `asyncWrite`: bypass the page cache, and the expected size of each file to preallocate
+    bool directIo = false;
+    std::uint64_t preallocate = 0;
+};
+
+/**
+ * @brief Same as `setupTest(testNumber)` with the files written as described by `options`.
+ *
+ * @note The streams are flushed and closed when destroyed.
+ */
+std::pair<std::unique_ptr<std::ostream>, std::unique_ptr<std::ostream>> setupTest(std::uint64_t testNumber,
+                                                                                  const OutputOptions &options);
+
 #endif
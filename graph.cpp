@@ -1,57 +1,214 @@
 #include "graph.hpp"
 #include "rand.hpp"
+#include "dag_layout.hpp"
+#include "grid_layout.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <deque>
+#include <optional>
 #include <queue>
 #include <set>
 #include <utility>
 #include <cmath>
 
-Graph& Graph::relabelNodes() {
-    auto perm = rnd.perm(getNumberOfNodes());
-    std::vector<std::uint64_t> inv_perm(getNumberOfNodes());
-    for (std::uint64_t i = 0; i < getNumberOfNodes(); i++) {
-        inv_perm[perm[i]] = i;
+Graph& Graph::relabelNodes(unsigned threads) {
+    TESTFRAME_SCOPED_TIMER("Graph::relabelNodes");
+    assert(getNumberOfNodes() == 0 || getNumberOfNodes() - 1 <= std::numeric_limits<NodeId>::max());
+    auto perm = rnd.perm<NodeId>(getNumberOfNodes());
+    // Lists are moved to their new positions instead of copying the whole graph.
+    std::vector<std::vector<NodeId>> relabeled(getNumberOfNodes());
+    parallelForChunks(0, getNumberOfNodes(), threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+        for (std::uint64_t v = from; v < to; ++v) {
+            for (auto& neigh : graph[v]) {
+                neigh = perm[neigh];
+            }
+            relabeled[perm[v]] = std::move(graph[v]);
+        }
+    });
+    graph = std::move(relabeled);
+    normalized = false;
+    return *this;
+}
+
+namespace {
+
+// Lists at least this long are radix sorted, shorter ones go to std::sort.
+constexpr std::size_t radixSortThreshold = 1024;
+
+// LSD radix sort on bytes, skipping the high bytes that are zero in every id below `nodes`. `buffer` is scratch
+// space and may trade storage with `list`.
+void radixSort(std::vector<NodeId> &list, std::vector<NodeId> &buffer, std::uint64_t nodes) {
+    buffer.resize(list.size());
+    for (unsigned shift = 0; shift < 8 * sizeof(NodeId) && (nodes - 1) >> shift != 0; shift += 8) {
+        std::array<std::size_t, 257> count{};
+        for (auto v : list) {
+            ++count[((v >> shift) & 0xff) + 1];
+        }
+        for (std::size_t digit = 0; digit < 256; ++digit) {
+            count[digit + 1] += count[digit];
+        }
+        for (auto v : list) {
+            buffer[count[(v >> shift) & 0xff]++] = v;
+        }
+        list.swap(buffer);
+    }
+}
+
+// The merges below are branch-free, both positions advance by comparison results, so random lists cost no
+// mispredictions and the loop bodies compile to conditional moves.
+void unionLists(const std::vector<NodeId> &a, const std::vector<NodeId> &b, std::vector<NodeId> &out) {
+    out.resize(a.size() + b.size());
+    std::size_t i = 0, j = 0, k = 0;
+    while (i < a.size() && j < b.size()) {
+        NodeId x = a[i], y = b[j];
+        out[k++] = std::min(x, y);
+        i += x <= y;
+        j += y <= x;
     }
-    auto graph_copy = graph;
-    for (std::uint64_t v = 0; v < getNumberOfNodes(); ++v) {
-        graph[v] = graph_copy[inv_perm[v]];
-        for (auto& neigh : graph[v]) {
-            neigh = perm[neigh];
+    k = std::copy(a.begin() + i, a.end(), out.begin() + k) - out.begin();
+    k = std::copy(b.begin() + j, b.end(), out.begin() + k) - out.begin();
+    out.resize(k);
+}
+
+void intersectLists(const std::vector<NodeId> &a, const std::vector<NodeId> &b, std::vector<NodeId> &out) {
+    out.resize(std::min(a.size(), b.size()));
+    std::size_t i = 0, j = 0, k = 0;
+    while (i < a.size() && j < b.size()) {
+        NodeId x = a[i], y = b[j];
+        out[k] = x;
+        k += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    out.resize(k);
+}
+
+void subtractLists(const std::vector<NodeId> &a, const std::vector<NodeId> &b, std::vector<NodeId> &out) {
+    out.resize(a.size());
+    std::size_t i = 0, j = 0, k = 0;
+    while (i < a.size() && j < b.size()) {
+        NodeId x = a[i], y = b[j];
+        out[k] = x;
+        k += x < y;
+        i += x <= y;
+        j += y <= x;
+    }
+    k = std::copy(a.begin() + i, a.end(), out.begin() + k) - out.begin();
+    out.resize(k);
+}
+
+template <typename Merge>
+Graph mergeGraphs(const Graph &a, const Graph &b, unsigned threads, Merge merge) {
+    assert(a.getNumberOfNodes() == b.getNumberOfNodes() && a.directed == b.directed);
+    // The merges need sorted lists, an input that is not normalized is normalized on a copy.
+    std::optional<Graph> copyA, copyB;
+    const Graph &sortedA = a.normalized ? a : copyA.emplace(a).normalize(false, threads);
+    const Graph &sortedB = b.normalized ? b : copyB.emplace(b).normalize(false, threads);
+    std::vector<std::vector<NodeId>> g(a.getNumberOfNodes());
+    parallelForChunks(0, g.size(), threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+        for (std::uint64_t v = from; v < to; ++v) {
+            merge(sortedA.graph[v], sortedB.graph[v], g[v]);
+        }
+    }, 64);
+    Graph result(std::move(g), a.directed);
+    result.normalized = true;
+    return result;
+}
+
+}  // namespace
+
+Graph &Graph::normalize(bool symmetrize, unsigned threads) {
+    TESTFRAME_SCOPED_TIMER("Graph::normalize");
+    const std::uint64_t n = getNumberOfNodes();
+    if (symmetrize) {
+        // Every reverse entry is appended, sorting and deduplication drop the ones that were already there.
+        std::vector<std::uint64_t> size(n), reverse(n, 0);
+        for (std::uint64_t v = 0; v < n; ++v) {
+            size[v] = graph[v].size();
+            for (auto u : graph[v]) {
+                ++reverse[u];
+            }
         }
+        for (std::uint64_t v = 0; v < n; ++v) {
+            graph[v].reserve(size[v] + reverse[v]);
+        }
+        for (std::uint64_t v = 0; v < n; ++v) {
+            for (std::uint64_t i = 0; i < size[v]; ++i) {
+                graph[graph[v][i]].push_back(v);
+            }
+        }
+        directed = false;
     }
+    std::vector<std::vector<NodeId>> buffers(resolveThreadCount(threads));
+    parallelForChunks(0, n, threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+        for (std::uint64_t v = from; v < to; ++v) {
+            auto &list = graph[v];
+            if (list.size() >= radixSortThreshold) {
+                radixSort(list, buffers[t], n);
+            } else {
+                std::sort(list.begin(), list.end());
+            }
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+        }
+    }, 64);
+    normalized = true;
     return *this;
 }
 
+Graph Graph::edgeUnion(const Graph &a, const Graph &b, unsigned threads) {
+    TESTFRAME_SCOPED_TIMER("Graph::edgeUnion");
+    return mergeGraphs(a, b, threads, unionLists);
+}
+
+Graph Graph::edgeIntersection(const Graph &a, const Graph &b, unsigned threads) {
+    TESTFRAME_SCOPED_TIMER("Graph::edgeIntersection");
+    return mergeGraphs(a, b, threads, intersectLists);
+}
+
+Graph Graph::edgeDifference(const Graph &a, const Graph &b, unsigned threads) {
+    TESTFRAME_SCOPED_TIMER("Graph::edgeDifference");
+    return mergeGraphs(a, b, threads, subtractLists);
+}
+
 std::uint64_t Graph::undirectedConnectedComponentsNumber() {
+    TESTFRAME_SCOPED_TIMER("Graph::undirectedConnectedComponentsNumber");
     std::uint64_t scc_number = 0;
     std::vector<bool> visited(getNumberOfNodes(), false);
 
-    std::function<void(std::uint64_t)> dfs = [&](std::uint64_t v) -> void {
-        visited[v] = true;
-        for (auto u : graph[v]) {
-            if (!visited[v]) {
-                dfs(u);
-            }
-        }
-    };
+    std::vector<std::uint64_t> stack;
 
     for (std::uint64_t v = 0; v < getNumberOfNodes(); v++) {
         if (!visited[v]) {
             visited[v] = true;
             scc_number++;
-            dfs(v);
+            stack.push_back(v);
+            while (!stack.empty()) {
+                std::uint64_t w = stack.back();
+                stack.pop_back();
+                for (auto u : graph[w]) {
+                    if (!visited[u]) {
+                        visited[u] = true;
+                        stack.push_back(u);
+                    }
+                }
+            }
         }
     }
     return scc_number;
 }
 
 Graph Graph::constructEmptyGraph(std::uint64_t nodes) {
-    std::vector<std::vector<std::uint64_t>> g;
+    TESTFRAME_SCOPED_TIMER("Graph::constructEmptyGraph");
+    std::vector<std::vector<NodeId>> g;
     g.resize(nodes);
-    return Graph(g);
+    return Graph(std::move(g));
 }
 
 Graph Graph::constructUndirectedClique(std::uint64_t nodes) {
-    std::vector<std::vector<std::uint64_t>> g;
+    TESTFRAME_SCOPED_TIMER("Graph::constructUndirectedClique");
+    std::vector<std::vector<NodeId>> g;
     g.resize(nodes);
     for (std::uint64_t i = 0; i < nodes; ++i) {
         for (std::uint64_t j = 0; j < nodes; ++j) {
@@ -63,11 +220,12 @@ Graph Graph::constructUndirectedClique(std::uint64_t nodes) {
         }
     }
 
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
 Graph Graph::constructPathGraph(std::uint64_t nodes, std::uint64_t numberOfComponents) {
-    std::vector<std::vector<std::uint64_t>> g(nodes);
+    TESTFRAME_SCOPED_TIMER("Graph::constructPathGraph");
+    std::vector<std::vector<NodeId>> g(nodes);
     std::vector part = rnd.partition(numberOfComponents, nodes);
     std::uint64_t current = 0;
     for (std::uint64_t l = 0; l < part.size(); ++l) {
@@ -79,11 +237,12 @@ Graph Graph::constructPathGraph(std::uint64_t nodes, std::uint64_t numberOfCompo
         }
         ++current;
     }
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
 Graph Graph::constructShallowForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees) {
-    std::vector<std::vector<std::uint64_t>> g;
+    TESTFRAME_SCOPED_TIMER("Graph::constructShallowForestGraph");
+    std::vector<std::vector<NodeId>> g;
     g.resize(nodes);
     std::vector pa = rnd.partition(numberOfTrees, nodes);
     std::uint64_t root = 0, sum = 0, pnt = 0;
@@ -97,21 +256,23 @@ Graph Graph::constructShallowForestGraph(std::uint64_t nodes, std::uint64_t numb
         g[neighbor].push_back(i);
         g[i].push_back(neighbor);
     }
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
 Graph Graph::constructShallowTreeGraph(std::uint64_t nodes) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructShallowTreeGraph");
     return constructShallowForestGraph(nodes, 1);
 }
 
-Graph Graph::constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees) {
-    std::vector<std::vector<std::uint64_t>> g;
+Graph Graph::constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees, std::pmr::memory_resource *scratch) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructForestGraph");
+    std::vector<std::vector<NodeId>> g;
     g.resize(nodes);
     std::vector pa = rnd.partition(numberOfTrees, nodes);
     std::uint64_t root = 0;
     for (auto currentNodes : pa) {
-        std::vector<std::uint64_t> prufer, cnt(currentNodes, 0);
-        std::vector<std::vector<std::uint64_t>> g_curr(currentNodes);
+        std::pmr::vector<std::uint64_t> prufer(scratch), cnt(currentNodes, 0, scratch);
+        std::pmr::vector<std::pmr::vector<std::uint64_t>> g_curr(currentNodes, scratch);
         if (currentNodes == 1) {
             root++;
             continue;
@@ -122,12 +283,14 @@ Graph Graph::constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTre
             root += 2;
             continue;
         }
+        prufer.reserve(currentNodes - 2);
         for (Random::IntType i = 0; i < currentNodes - 2; i++) {
             std::uint64_t x = rnd.intFromRange(currentNodes - 1);
             prufer.push_back(x);
             ++cnt[x];
         }
-        std::priority_queue<std::uint64_t> q;
+        std::priority_queue<std::uint64_t, std::pmr::vector<std::uint64_t>> q{std::less<std::uint64_t>{},
+                                                                            std::pmr::vector<std::uint64_t>(scratch)};
         for (Random::IntType i = 0; i < currentNodes; ++i) {
             if (!cnt[i]) {
                 q.push(i);
@@ -148,7 +311,7 @@ Graph Graph::constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTre
         g_curr[x].push_back(y);
         g_curr[y].push_back(x);
 
-        std::queue<std::uint64_t> bfs;
+        std::queue<std::uint64_t, std::pmr::deque<std::uint64_t>> bfs{std::pmr::deque<std::uint64_t>(scratch)};
 
         bfs.push(0);
         std::uint64_t _id = root;
@@ -167,16 +330,18 @@ Graph Graph::constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTre
             ++_id;
         }
     }
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
-Graph Graph::constructTreeGraph(std::uint64_t nodes) {
-    return constructForestGraph(nodes, 1);
+Graph Graph::constructTreeGraph(std::uint64_t nodes, std::pmr::memory_resource *scratch) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructTreeGraph");
+    return constructForestGraph(nodes, 1, scratch);
 }
 
 Graph Graph::constructSimplerJellyfishGraph(std::uint64_t nodes, std::uint64_t cycleSize, std::uint64_t minTentacleLength,
                                             std::uint64_t numberOfTentacles) {
-    std::vector<std::vector<std::uint64_t>> g;
+    TESTFRAME_SCOPED_TIMER("Graph::constructSimplerJellyfishGraph");
+    std::vector<std::vector<NodeId>> g;
     g.resize(nodes);
     std::vector pa = rnd.partition(numberOfTentacles, nodes - cycleSize, minTentacleLength);
     std::uint64_t next = 1;
@@ -187,10 +352,13 @@ Graph Graph::constructSimplerJellyfishGraph(std::uint64_t nodes, std::uint64_t c
         prev = next;
         next++;
     }
-    g[prev].push_back(0);
-    g[0].push_back(prev);
+    // Cycles of 1 or 2 nodes are not closed, that would add a self-loop or repeat an edge.
+    if (cycleSize >= 3) {
+        g[prev].push_back(0);
+        g[0].push_back(prev);
+    }
     for (std::uint64_t raySize : pa) {
-        prev = rnd.intFromRange(cycleSize - 1);  // Ray starts at node in [0, cycyleSize - 1]
+        prev = cycleSize > 1 ? rnd.intFromRange(cycleSize - 1) : 0;  // Ray starts at node in [0, cycyleSize - 1]
         for (std::uint64_t i = 0; i < raySize; i++) {
             g[prev].push_back(next);
             g[next].push_back(prev);
@@ -198,16 +366,18 @@ Graph Graph::constructSimplerJellyfishGraph(std::uint64_t nodes, std::uint64_t c
             next++;
         }
     }
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
 Graph Graph::constructStarfishGraph(std::uint64_t nodes, std::uint64_t minRayLength, std::uint64_t numberOfRays) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructStarfishGraph");
     return constructSimplerJellyfishGraph(nodes, 1, minRayLength, numberOfRays);
 }
 
 /* Silkworm of size n is a path of size (n+1)/2 and one private node for each node from path */
 Graph Graph::constructSilkwormGraph(std::uint64_t nodes) {
-    std::vector<std::vector<std::uint64_t>> g;
+    TESTFRAME_SCOPED_TIMER("Graph::constructSilkwormGraph");
+    std::vector<std::vector<NodeId>> g;
     g.resize(nodes);
     for (std::uint64_t i = 0; i < nodes; i += 2) {
         if (i + 1 < nodes) {
@@ -220,15 +390,16 @@ Graph Graph::constructSilkwormGraph(std::uint64_t nodes) {
         }
     }
 
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
-Graph Graph::constructTreeOfBoundedDegreeGraph(std::uint64_t nodes, std::uint64_t minDegree, std::uint64_t maxDegree) {
-    std::vector<std::vector<std::uint64_t>> g(nodes);
-    std::vector<std::uint64_t> vec(nodes);
-    std::iota(begin(vec), end(vec), 0);
-    std::deque<std::uint64_t> availableLeaves(std::begin(vec), std::end(vec));
-    std::queue<std::uint64_t> inTree;
+Graph Graph::constructTreeOfBoundedDegreeGraph(std::uint64_t nodes, std::uint64_t minDegree, std::uint64_t maxDegree,
+                                               std::pmr::memory_resource *scratch) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructTreeOfBoundedDegreeGraph");
+    std::vector<std::vector<NodeId>> g(nodes);
+    std::pmr::deque<std::uint64_t> availableLeaves(nodes, scratch);
+    std::iota(availableLeaves.begin(), availableLeaves.end(), 0);
+    std::queue<std::uint64_t, std::pmr::deque<std::uint64_t>> inTree{std::pmr::deque<std::uint64_t>(scratch)};
     availableLeaves.pop_front();
     inTree.push(0);  // move 0 from availableLeaves to inTree
     while (!availableLeaves.empty() && !inTree.empty()) {
@@ -244,10 +415,11 @@ Graph Graph::constructTreeOfBoundedDegreeGraph(std::uint64_t nodes, std::uint64_
             g[nextNode].push_back(currentNode);
         }
     }
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
 Graph Graph::constructSparseGraph(std::uint64_t nodes) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructSparseGraph");
     std::uint64_t number_of_edges = rnd.intFromRange(nodes * static_cast<std::uint64_t>(std::sqrt(nodes)) / 2);
     std::set<std::pair<int, int>> edges;
     while ((std::uint64_t)edges.size() < number_of_edges) {
@@ -258,15 +430,16 @@ Graph Graph::constructSparseGraph(std::uint64_t nodes) {
         }
         edges.insert({a, b});
     }
-    std::vector<std::vector<std::uint64_t>> g(nodes);
+    std::vector<std::vector<NodeId>> g(nodes);
     for (auto [a, b] : edges) {
         g[a].push_back(b);
         g[b].push_back(a);
     }
-    return Graph(g).relabelNodes();
+    return Graph(std::move(g)).relabelNodes();
 }
 
 Graph Graph::constructDenseGraph(std::uint64_t nodes) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructDenseGraph");
     std::vector<std::pair<int, int>> all_edges;
     all_edges.reserve(nodes * (nodes - 1) / 2);
     for (std::uint64_t i = 0; i < nodes; i++) {
@@ -281,41 +454,60 @@ Graph Graph::constructDenseGraph(std::uint64_t nodes) {
         nodes * (nodes - 1) / 2
     );
     all_edges.resize(number_of_edges);
-    std::vector<std::vector<std::uint64_t>> g(nodes);
+    std::vector<std::vector<NodeId>> g(nodes);
     for (auto [a, b] : all_edges) {
         g[a].push_back(b);
         g[b].push_back(a);
     }
-    return Graph(g).relabelNodes();
-}
-
-Graph Graph::constructRandomDAG(std::uint64_t nodes, std::uint64_t edges, std::uint64_t height) {
-    std::vector<std::vector<std::uint64_t>> g(nodes);
-    std::vector pa = rnd.partition(height, nodes, 1);
-    std::vector<std::vector<std::uint64_t>> layers(pa.size());
-    uint64_t number_of_layers = pa.size();
-    for (uint64_t i = 1; i < pa.size(); i++) {
-        pa[i] += pa[i - 1];
-    } 
-    int j = 0;
-    for (uint64_t i = 0; i < number_of_layers; i++) {
-        while (j < pa[i]) {
-            layers[i].push_back(j);
-            j++;
-        }
-    } 
-    for (uint64_t i = 0; i < edges; i ++) { // high_layer -> edge -> low_layer
-        uint64_t from_layer = rnd.intFromRange(1, number_of_layers - 1);
-        uint64_t to_layer = rnd.intFromRange(0, from_layer - 1);
-        uint64_t from_node = layers[from_layer][rnd.intFromRange(0, layers[from_layer].size() - 1)];
-        uint64_t to_node = layers[to_layer][rnd.intFromRange(0, layers[to_layer].size() - 1)];
-        g[from_node].push_back(to_node);
+    return Graph(std::move(g)).relabelNodes();
+}
+
+Graph Graph::constructRandomDAG(std::uint64_t nodes, std::uint64_t edges, std::uint64_t height,
+                                std::pmr::memory_resource *scratch, unsigned threads) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructRandomDAG");
+    auto sizes = rnd.partition(height, nodes, 1);
+    return constructRandomDAG(std::vector<std::uint64_t>(sizes.begin(), sizes.end()), edges, scratch, threads);
+}
+
+Graph Graph::constructRandomDAG(const std::vector<std::uint64_t> &layerSizes, std::uint64_t edges,
+                                std::pmr::memory_resource *scratch, unsigned threads) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructRandomDAG");
+    DagLayout layout(layerSizes);
+    assert(edges <= layout.getNumberOfPairs());
+
+    // A sorted sample of candidate numbers, so every node's edges form one contiguous run.
+    std::pmr::vector<std::uint64_t> pairs(scratch);
+    pairs.reserve(edges);
+    SortedSampler sampler(rnd, edges, layout.getNumberOfPairs());
+    while (sampler.hasNext()) {
+        pairs.push_back(sampler.next());
     }
-    return Graph(g, true).relabelNodes();
+
+    std::vector<std::vector<NodeId>> g(layout.getNumberOfNodes());
+    parallelForChunks(0, layout.getNumberOfNodes(), threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+        std::size_t layer = layout.getLayer(from);
+        auto pair = std::lower_bound(pairs.begin(), pairs.end(), layout.getFirstPair(from, layer));
+        for (std::uint64_t u = from; u < to; ++u) {
+            while (u >= layout.getLayerStart(layer + 1)) {
+                ++layer;
+            }
+            std::uint64_t first = layout.getFirstPair(u, layer);
+            auto end = pair;
+            while (end != pairs.end() && *end - first < layout.getLayerStart(layer)) {
+                ++end;
+            }
+            g[u].reserve(end - pair);
+            for (; pair != end; ++pair) {
+                g[u].push_back(*pair - first);
+            }
+        }
+    });
+    return Graph(std::move(g), true).relabelNodes(threads);
 }
 
 Graph Graph::constructDirectedGraph(Graph graph) {
-    std::vector<std::vector<std::uint64_t>> g(graph.getNumberOfNodes());
+    TESTFRAME_SCOPED_TIMER("Graph::constructDirectedGraph");
+    std::vector<std::vector<NodeId>> g(graph.getNumberOfNodes());
     assert(!graph.directed);
     for (auto [u, v] : graph.getEdges()) {
         if (u <= v) {
@@ -328,7 +520,182 @@ Graph Graph::constructDirectedGraph(Graph graph) {
             }
         }
     }
-    return Graph(g, true).relabelNodes();
+    return Graph(std::move(g), true).relabelNodes();
+}
+
+namespace {
+
+void replaceOne(std::vector<NodeId> &list, std::uint64_t from, std::uint64_t to) {
+    *std::find(list.begin(), list.end(), from) = to;
+}
+
+bool contains(const std::vector<NodeId> &list, std::uint64_t value) {
+    return std::find(list.begin(), list.end(), value) != list.end();
+}
+
+Graph constructGrid(std::uint64_t rows, std::uint64_t columns, bool wrap) {
+    assert(rows > 0 && columns > 0);
+    GridLayout layout(rows, columns, wrap);
+    std::vector<std::vector<NodeId>> g(layout.getNumberOfNodes());
+    for (std::uint64_t u = 0; u < layout.getNumberOfNodes(); ++u) {
+        g[u].reserve(layout.getDegree(u));
+        layout.forEachNeighbor(u, [&](std::uint64_t v) {
+            g[u].push_back(v);
+        });
+    }
+    return Graph(std::move(g)).relabelNodes();
+}
+
+}  // namespace
+
+Graph Graph::constructRegularGraph(std::uint64_t nodes, std::uint64_t degree) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructRegularGraph");
+    assert(degree < nodes && nodes * degree % 2 == 0);
+    if (2 * degree > nodes) {
+        // Switchings rarely succeed close to the complete graph, so take the complement of a sparse one.
+        Graph complement = constructRegularGraph(nodes, nodes - 1 - degree);
+        std::vector<std::vector<NodeId>> g(nodes);
+        std::vector<bool> adjacent(nodes);
+        for (std::uint64_t u = 0; u < nodes; ++u) {
+            for (auto v : complement.graph[u]) {
+                adjacent[v] = true;
+            }
+            g[u].reserve(degree);
+            for (std::uint64_t v = 0; v < nodes; ++v) {
+                if (v != u && !adjacent[v]) {
+                    g[u].push_back(v);
+                }
+            }
+            for (auto v : complement.graph[u]) {
+                adjacent[v] = false;
+            }
+        }
+        return Graph(std::move(g));
+    }
+
+    // Configuration model: a random perfect matching of `degree` stubs per node.
+    std::vector<std::vector<NodeId>> g(nodes);
+    {
+        std::vector<NodeId> stubs(nodes * degree);
+        for (std::uint64_t i = 0; i < stubs.size(); ++i) {
+            stubs[i] = i / degree;
+        }
+        rnd.shuffle(stubs);
+        for (auto &list : g) {
+            list.reserve(degree);
+        }
+        for (std::uint64_t i = 0; i < stubs.size(); i += 2) {
+            g[stubs[i]].push_back(stubs[i + 1]);
+            g[stubs[i + 1]].push_back(stubs[i]);
+        }
+    }
+
+    // Self-loops and repeated edges, each listed once per extra copy.
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> bad;
+    std::vector<std::uint64_t> seenFrom(nodes, nodes);
+    for (std::uint64_t u = 0; u < nodes; ++u) {
+        std::uint64_t loopEntries = 0;
+        for (auto v : g[u]) {
+            if (v == u) {
+                loopEntries++;
+            } else if (v > u) {
+                if (seenFrom[v] == u) {
+                    bad.emplace_back(u, v);
+                }
+                seenFrom[v] = u;
+            }
+        }
+        for (std::uint64_t i = 0; i < loopEntries / 2; ++i) {
+            bad.emplace_back(u, u);
+        }
+    }
+
+    // Every bad edge {u, v} is switched with a uniformly random edge {x, y} into {u, x} and {v, y}, as long as that
+    // does not create a new loop or repeated edge.
+    for (auto [u, v] : bad) {
+        bool stillBad = u == v ? std::count(g[u].begin(), g[u].end(), u) >= 2
+                               : std::count(g[u].begin(), g[u].end(), v) >= 2;
+        while (stillBad) {
+            std::uint64_t x = rnd.intFromRange(nodes - 1);
+            std::uint64_t y = g[x][rnd.intFromRange(degree - 1)];
+            if (u == x || v == y || (u == y && v == x) || (u == v && x == y) || contains(g[u], x) || contains(g[v], y)) {
+                continue;
+            }
+            replaceOne(g[u], v, x);
+            replaceOne(g[v], u, y);
+            replaceOne(g[x], y, u);
+            replaceOne(g[y], x, v);
+            stillBad = false;
+        }
+    }
+    return Graph(std::move(g)).relabelNodes();
+}
+
+Graph Graph::constructBipartiteGraph(std::uint64_t leftNodes, std::uint64_t rightNodes, double probability) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructBipartiteGraph");
+    assert(0. <= probability && probability <= 1.);
+    const std::uint64_t pairs = leftNodes * rightNodes;
+    // Geometric skipping: the gap to the next present pair is geometric, so only present pairs cost time.
+    auto forEachPair = [&](Random &random, auto &&f) {
+        if (probability <= 0.) {
+            return;
+        }
+        const double logQ = std::log1p(-probability);
+        for (std::uint64_t index = 0;; ++index) {
+            if (probability < 1.) {
+                double skip = std::floor(std::log1p(-random.doubleFromRange(1.)) / logQ);
+                if (skip >= static_cast<double>(pairs - index)) {
+                    return;
+                }
+                index += static_cast<std::uint64_t>(skip);
+            }
+            if (index >= pairs) {
+                return;
+            }
+            f(index / rightNodes, leftNodes + index % rightNodes);
+        }
+    };
+
+    // The first pass replays a copy of `rnd` to count degrees, so every list is allocated once with its exact size.
+    std::vector<std::uint64_t> degree(leftNodes + rightNodes, 0);
+    Random replay = rnd;
+    forEachPair(replay, [&](std::uint64_t u, std::uint64_t v) {
+        degree[u]++;
+        degree[v]++;
+    });
+    std::vector<std::vector<NodeId>> g(leftNodes + rightNodes);
+    for (std::uint64_t u = 0; u < g.size(); ++u) {
+        g[u].reserve(degree[u]);
+    }
+    forEachPair(rnd, [&](std::uint64_t u, std::uint64_t v) {
+        g[u].push_back(v);
+        g[v].push_back(u);
+    });
+    return Graph(std::move(g)).relabelNodes();
+}
+
+Graph Graph::constructBicliqueGraph(std::uint64_t leftNodes, std::uint64_t rightNodes) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructBicliqueGraph");
+    std::vector<std::vector<NodeId>> g(leftNodes + rightNodes);
+    for (std::uint64_t u = 0; u < leftNodes; ++u) {
+        g[u].resize(rightNodes);
+        std::iota(g[u].begin(), g[u].end(), leftNodes);
+    }
+    for (std::uint64_t v = leftNodes; v < leftNodes + rightNodes; ++v) {
+        g[v].resize(leftNodes);
+        std::iota(g[v].begin(), g[v].end(), std::uint64_t{0});
+    }
+    return Graph(std::move(g)).relabelNodes();
+}
+
+Graph Graph::constructLatticeGraph(std::uint64_t rows, std::uint64_t columns) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructLatticeGraph");
+    return constructGrid(rows, columns, true);
+}
+
+Graph Graph::constructGridGraph(std::uint64_t rows, std::uint64_t columns) {
+    TESTFRAME_SCOPED_TIMER("Graph::constructGridGraph");
+    return constructGrid(rows, columns, false);
 }
 
 // Ścieżka // Zbiór ścieżek
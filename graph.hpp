@@ -2,38 +2,23 @@
 #define GRAPH_H_
 
 #include "utils.hpp"
+#include "instrument.hpp"
+#include "graph_view.hpp"
+#include <cassert>
+#include <concepts>
+#include <limits>
 #include <numeric>
 #include <functional>
+#include <memory_resource>
 
 class Graph {
 public:
     bool directed = false;
-    std::vector<std::vector<std::uint64_t>> graph;
-    enum class PrintFormat {
-        PromptAdjecencyList,
-        SolutionAdjecencyList,
-        PromptAdjecencyMatrix,
-        SolutionAdjecencyMatrix
-    };
+    std::vector<std::vector<NodeId>> graph;
+    // Set by `normalize` and cleared by `relabelNodes`, code that edits `graph` directly afterwards has to clear it.
+    bool normalized = false;
+    using PrintFormat = GraphPrintFormat;
 private:
-    void printPromptAdjecencyListTo(std::ostream &outputStream) const {
-        outputStream << "{";
-        for (std::uint64_t i = 0; i < getNumberOfNodes(); ++i) {
-            outputStream << "{";
-            for (std::uint64_t j = 0; j < graph[i].size(); ++j) {
-                outputStream << graph[i][j];
-                if (j != graph[i].size() - 1) {
-                    outputStream << ",";
-                }
-            }
-            outputStream << "}";
-            if (i != getNumberOfNodes() - 1) {
-                outputStream << ",";
-            }
-        }
-        outputStream << "}\n";
-    }
-
     void printPromptAdjecencyMatrixTo(std::ostream &outputStream) const {
         auto nodes = getNumberOfNodes();
 
@@ -80,28 +65,48 @@ private:
         }
     }
 
-    void printSolutionAdjecencyListTo(std::ostream &outputStream) const {
-        auto edges = getEdges();
+public:
+    Graph(std::vector<std::vector<NodeId>> g, bool directed = false)
+        : directed(directed),
+          graph(std::move(g)) {}
 
-        outputStream << getNumberOfNodes() << " " << edges.size() << "\n";
-        for (auto edge : edges) {
-            outputStream << edge.first << " " << edge.second << "\n";
+    // Converts lists of another id type, every id has to fit in `NodeId`.
+    template <std::integral T>
+    requires (!std::same_as<T, NodeId>)
+    Graph(const std::vector<std::vector<T>> &g, bool directed = false)
+        : directed(directed),
+          graph(g.size()) {
+        for (std::uint64_t v = 0; v < g.size(); ++v) {
+            graph[v].reserve(g[v].size());
+            for (auto u : g[v]) {
+                assert(static_cast<std::uint64_t>(u) <= std::numeric_limits<NodeId>::max());
+                graph[v].push_back(static_cast<NodeId>(u));
+            }
         }
     }
-public:
-    Graph(std::vector<std::vector<std::uint64_t>> g, bool directed = false)
-        : directed(directed),
-          graph(g) {}
 
     std::uint64_t getNumberOfNodes() const {
         return graph.size();
     }
 
     std::uint64_t getNumberOfEdges() const {
-        return std::accumulate(graph.begin(), graph.end(), 0,
+        return std::accumulate(graph.begin(), graph.end(), std::uint64_t{0},
                                [](const std::uint64_t x, const auto &a) { return x + a.size(); });
     }
 
+    std::uint64_t getDegree(std::uint64_t node) const {
+        return graph[node].size();
+    }
+
+    template <typename F>
+    void forEachNeighbor(std::uint64_t node, F &&f) const {
+        for (auto neighbour : graph[node]) {
+            if (!visitNeighbor(f, neighbour)) {
+                return;
+            }
+        }
+    }
+
     std::vector<std::vector<std::uint64_t>> getAdjecencyMatrix() const {
         std::uint64_t n = getNumberOfNodes();
         std::vector<std::vector<std::uint64_t>> adjMatrix(n, std::vector<std::uint64_t>(n, 0));
@@ -115,6 +120,7 @@ public:
         return adjMatrix;
     }
 
+    // Compares the lists in order, `normalize` both graphs first to compare edge sets.
     bool operator==(const Graph &other) const {
         if (getNumberOfNodes() != other.getNumberOfNodes()) {
             return false;
@@ -129,10 +135,15 @@ public:
     }
 
     operator std::vector<std::vector<std::uint64_t>>() const {
-        return graph;
+        std::vector<std::vector<std::uint64_t>> g(graph.size());
+        for (std::uint64_t v = 0; v < graph.size(); ++v) {
+            g[v].assign(graph[v].begin(), graph[v].end());
+        }
+        return g;
     }
 
     std::vector<std::pair<std::uint64_t, std::uint64_t>> getEdges() const {
+        TESTFRAME_SCOPED_TIMER("Graph::getEdges");
         std::vector<std::pair<std::uint64_t, std::uint64_t>> edges;
         for (std::uint64_t v = 0; v < getNumberOfNodes() ; ++v)
             for (std::uint64_t u : graph[v])
@@ -140,52 +151,78 @@ public:
         return edges;
     }
 
-    Graph &relabelNodes();
-
-    void printTo(std::ostream &outputStream, PrintFormat format) const {
-        switch (format) {
-            case PrintFormat::PromptAdjecencyList:
-                printPromptAdjecencyListTo(outputStream);
-                break;
-            case PrintFormat::SolutionAdjecencyList:
-                printSolutionAdjecencyListTo(outputStream);
-                break;
-            case PrintFormat::PromptAdjecencyMatrix:
-                printPromptAdjecencyListTo(outputStream);
-                break;
-            case PrintFormat::SolutionAdjecencyMatrix:
-                printSolutionAdjecencyListTo(outputStream);
-                break;
-        }
+    // The permutation is drawn from `rnd` up front, so the result does not depend on `threads`.
+    Graph &relabelNodes(unsigned threads = 1);
+
+    /**
+     * @brief Sorts every adjacency list and removes repeated entries, in parallel over nodes, and sets `normalized`.
+     *
+     * Long lists are radix sorted on the bytes of the node ids. With `symmetrize` the reverse of every entry is added
+     * as well and the graph becomes undirected.
+     */
+    Graph &normalize(bool symmetrize = false, unsigned threads = 1);
+
+    // Edge set operations on graphs with the same nodes and direction, one linear merge per list; the result is
+    // normalized. Inputs that are not normalized are normalized on a copy first.
+    static Graph edgeUnion(const Graph &a, const Graph &b, unsigned threads = 1);
+    static Graph edgeIntersection(const Graph &a, const Graph &b, unsigned threads = 1);
+    static Graph edgeDifference(const Graph &a, const Graph &b, unsigned threads = 1);
+
+    // `threads` format node ranges in parallel, the output does not depend on it.
+    void printTo(std::ostream &outputStream, PrintFormat format, unsigned threads = 1) const {
+        TESTFRAME_SCOPED_TIMER("Graph::printTo");
+        TESTFRAME_COUNT_BYTES_WRITTEN(outputStream);
+        printGraphTo(*this, outputStream, format, threads);
     }
 
     static Graph readGraph(std::istream &inputStream) {
+        TESTFRAME_SCOPED_TIMER("Graph::readGraph");
         std::uint64_t nodes, numberOfEdges;
         inputStream >> nodes >> numberOfEdges;
-        std::vector<std::vector<std::uint64_t>> g(nodes);
+        std::vector<std::vector<NodeId>> g(nodes);
         for (std::uint64_t i = 0; i < numberOfEdges; i++) {
             std::uint64_t a, b;
             inputStream >> a >> b;
             g[a].push_back(b);
         }
-        return Graph(g);
+        return Graph(std::move(g));
     }
 
+    // Generators taking `scratch` allocate all their temporary containers from it, see `ScratchArena`.
     static Graph constructEmptyGraph(std::uint64_t nodes);
     static Graph constructUndirectedClique(std::uint64_t nodes);
     static Graph constructPathGraph(std::uint64_t nodes, std::uint64_t numberOfComponents = 1);
     static Graph constructShallowForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees);
     static Graph constructShallowTreeGraph(std::uint64_t nodes);
-    static Graph constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees);
-    static Graph constructTreeGraph(std::uint64_t nodes);
+    static Graph constructForestGraph(std::uint64_t nodes, std::uint64_t numberOfTrees,
+                                      std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
+    static Graph constructTreeGraph(std::uint64_t nodes,
+                                    std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
     static Graph constructSimplerJellyfishGraph(std::uint64_t nodes, std::uint64_t cycleSize, std::uint64_t minTentacleLength,
                                                    std::uint64_t numberOfTentacles);
     static Graph constructStarfishGraph(std::uint64_t nodes, std::uint64_t minRayLength, std::uint64_t numberOfRays);
     static Graph constructSilkwormGraph(std::uint64_t nodes);
-    static Graph constructTreeOfBoundedDegreeGraph(std::uint64_t nodes, std::uint64_t minDegree, std::uint64_t maxDegree);
+    static Graph constructTreeOfBoundedDegreeGraph(std::uint64_t nodes, std::uint64_t minDegree, std::uint64_t maxDegree,
+                                                   std::pmr::memory_resource *scratch = std::pmr::get_default_resource());
     static Graph constructSparseGraph(std::uint64_t nodes);
     static Graph constructDenseGraph(std::uint64_t nodes);
-    static Graph constructRandomDAG(std::uint64_t nodes, std::uint64_t edges, std::uint64_t height);
+    // DAG with exactly `edges` distinct edges, nodes are split into `height` non-empty layers of random sizes and
+    // edges go from higher to lower layers, uniformly among all such pairs; the output does not depend on `threads`
+    static Graph constructRandomDAG(std::uint64_t nodes, std::uint64_t edges, std::uint64_t height,
+                                    std::pmr::memory_resource *scratch = std::pmr::get_default_resource(),
+                                    unsigned threads = 1);
+    // same with the given layer sizes (empty layers are allowed)
+    static Graph constructRandomDAG(const std::vector<std::uint64_t> &layerSizes, std::uint64_t edges,
+                                    std::pmr::memory_resource *scratch = std::pmr::get_default_resource(),
+                                    unsigned threads = 1);
+    // random simple `degree`-regular graph, `nodes * degree` has to be even
+    static Graph constructRegularGraph(std::uint64_t nodes, std::uint64_t degree);
+    // every one of the `leftNodes * rightNodes` edges between the two sides is present with `probability`
+    static Graph constructBipartiteGraph(std::uint64_t leftNodes, std::uint64_t rightNodes, double probability);
+    static Graph constructBicliqueGraph(std::uint64_t leftNodes, std::uint64_t rightNodes);
+    // `rows` x `columns` torus
+    static Graph constructLatticeGraph(std::uint64_t rows, std::uint64_t columns);
+    static Graph constructGridGraph(std::uint64_t rows, std::uint64_t columns);
     static Graph constructDirectedGraph(Graph graph);
 
     bool isClique() {
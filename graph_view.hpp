@@ -0,0 +1,113 @@
+#ifndef GRAPH_VIEW_H_
+#define GRAPH_VIEW_H_
+
+#include "format.hpp"
+#include <concepts>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+// Node ids stored in adjacency lists. 32 bits halve the memory of `Graph` and `WeightedGraph`; configure with
+// -DTESTFRAME_64BIT_NODE_IDS=ON for graphs with 2^32 nodes or more. Interfaces still take and return `std::uint64_t`.
+#ifdef TESTFRAME_64BIT_NODE_IDS
+using NodeId = std::uint64_t;
+#else
+using NodeId = std::uint32_t;
+#endif
+
+// Edge weights of `WeightedGraph`. A (NodeId, Weight) entry is padded to 16 bytes unless both are 32 bits, so
+// -DTESTFRAME_32BIT_WEIGHTS=ON halves weighted graphs when the weights fit.
+#ifdef TESTFRAME_32BIT_WEIGHTS
+using Weight = std::int32_t;
+#else
+using Weight = std::int64_t;
+#endif
+
+// Calls `f(neighbour)` and returns false if `f` asks to stop, callbacks returning bool stop the enumeration with false.
+template <typename F>
+bool visitNeighbor(F &f, std::uint64_t neighbour) {
+    if constexpr (std::is_same_v<std::invoke_result_t<F &, std::uint64_t>, bool>) {
+        return f(neighbour);
+    } else {
+        f(neighbour);
+        return true;
+    }
+}
+
+/**
+ * @brief Read-only adjacency interface shared by `Graph` and the implicit views of `implicit_graph.hpp`, accepted by
+ * the printers below, `parallelBfs` and `computeGraphProperties`.
+ *
+ * `forEachNeighbor(v, f)` calls `f(u)` for every adjacency entry v -> u in a fixed order; if `f` returns bool,
+ * returning false stops the enumeration early.
+ */
+template <typename G>
+concept GraphLike = requires(const G &g, std::uint64_t v) {
+    { g.directed } -> std::convertible_to<bool>;
+    { g.getNumberOfNodes() } -> std::convertible_to<std::uint64_t>;
+    { g.getNumberOfEdges() } -> std::convertible_to<std::uint64_t>;
+    { g.getDegree(v) } -> std::convertible_to<std::uint64_t>;
+    g.forEachNeighbor(v, [](std::uint64_t) {});
+};
+
+enum class GraphPrintFormat {
+    PromptAdjecencyList,
+    SolutionAdjecencyList,
+    PromptAdjecencyMatrix,
+    SolutionAdjecencyMatrix
+};
+
+// The printers take `threads` for `printInParallel`, the output does not depend on it.
+template <GraphLike G>
+void printPromptAdjecencyList(const G &graph, std::ostream &outputStream, unsigned threads = 1) {
+    const std::uint64_t nodes = graph.getNumberOfNodes();
+    outputStream << '{';
+    printInParallel(outputStream, nodes, threads, [&](std::uint64_t i) { return graph.getDegree(i); },
+                    [&](TextWriter &out, std::uint64_t i) {
+        out << '{';
+        bool first = true;
+        graph.forEachNeighbor(i, [&](std::uint64_t neighbour) {
+            if (!first) {
+                out << ',';
+            }
+            out << neighbour;
+            first = false;
+        });
+        out << '}';
+        if (i != nodes - 1) {
+            out << ',';
+        }
+    });
+    outputStream << "}\n";
+}
+
+template <GraphLike G>
+void printSolutionAdjecencyList(const G &graph, std::ostream &outputStream, unsigned threads = 1) {
+    const std::uint64_t nodes = graph.getNumberOfNodes();
+    {
+        TextWriter out(outputStream);
+        out << nodes << ' ' << graph.getNumberOfEdges() << '\n';
+    }
+    printInParallel(outputStream, nodes, threads, [&](std::uint64_t v) { return graph.getDegree(v); },
+                    [&](TextWriter &out, std::uint64_t v) {
+        graph.forEachNeighbor(v, [&](std::uint64_t u) {
+            out << v << ' ' << u << '\n';
+        });
+    });
+}
+
+template <GraphLike G>
+void printGraphTo(const G &graph, std::ostream &outputStream, GraphPrintFormat format, unsigned threads = 1) {
+    switch (format) {
+        case GraphPrintFormat::PromptAdjecencyList:
+        case GraphPrintFormat::PromptAdjecencyMatrix:
+            printPromptAdjecencyList(graph, outputStream, threads);
+            break;
+        case GraphPrintFormat::SolutionAdjecencyList:
+        case GraphPrintFormat::SolutionAdjecencyMatrix:
+            printSolutionAdjecencyList(graph, outputStream, threads);
+            break;
+    }
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef GRID_LAYOUT_H_
+#define GRID_LAYOUT_H_
+
+#include <cstdint>
+
+/**
+ * @brief Implicit `rows` x `columns` grid, node (r, c) is `r * columns + c`, shared by `Graph` and `EdgeStream`.
+ *
+ * Every node is joined to its 4 neighbours. With `wrap` the grid is a torus (lattice), the wrap-around edges of a
+ * dimension are only added when it has at least 3 nodes, so the graph stays simple.
+ */
+class GridLayout {
+public:
+    GridLayout(std::uint64_t rows, std::uint64_t columns, bool wrap)
+        : rows(rows), columns(columns), wrapRows(wrap && rows >= 3), wrapColumns(wrap && columns >= 3) {}
+
+    std::uint64_t getNumberOfNodes() const {
+        return rows * columns;
+    }
+
+    std::uint64_t getDegree(std::uint64_t node) const {
+        std::uint64_t r = node / columns, c = node % columns;
+        return (wrapRows ? 2 : (r > 0) + (r + 1 < rows)) + (wrapColumns ? 2 : (c > 0) + (c + 1 < columns));
+    }
+
+    // sum of all degrees, i.e. the number of adjacency entries
+    std::uint64_t getNumberOfEdges() const {
+        std::uint64_t vertical = wrapRows ? rows * columns : (rows - 1) * columns;
+        std::uint64_t horizontal = wrapColumns ? rows * columns : rows * (columns - 1);
+        return 2 * (vertical + horizontal);
+    }
+
+    // Calls `f(neighbour)` for every neighbour of `node`.
+    template <typename F>
+    void forEachNeighbor(std::uint64_t node, F &&f) const {
+        std::uint64_t r = node / columns, c = node % columns;
+        if (r > 0 || wrapRows) {
+            f((r > 0 ? r - 1 : rows - 1) * columns + c);
+        }
+        if (r + 1 < rows || wrapRows) {
+            f((r + 1 < rows ? r + 1 : 0) * columns + c);
+        }
+        if (c > 0 || wrapColumns) {
+            f(r * columns + (c > 0 ? c - 1 : columns - 1));
+        }
+        if (c + 1 < columns || wrapColumns) {
+            f(r * columns + (c + 1 < columns ? c + 1 : 0));
+        }
+    }
+
+private:
+    std::uint64_t rows;
+    std::uint64_t columns;
+    bool wrapRows;
+    bool wrapColumns;
+};
+
+#endif
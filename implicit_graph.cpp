@@ -0,0 +1,36 @@
+#include "implicit_graph.hpp"
+
+ImplicitClique::ImplicitClique(std::uint64_t nodes) : nodes(nodes) {
+    relabelNodes(nodes);
+}
+
+ImplicitPath::ImplicitPath(std::uint64_t nodes, std::uint64_t numberOfComponents)
+    : numberOfComponents(numberOfComponents), componentStart(nodes + 1, false) {
+    std::uint64_t start = 0;
+    for (auto length : rnd.partition(numberOfComponents, nodes)) {
+        componentStart[start] = true;
+        start += length;
+    }
+    componentStart[nodes] = true;
+    relabelNodes(nodes);
+}
+
+ImplicitSilkworm::ImplicitSilkworm(std::uint64_t nodes) : nodes(nodes) {
+    relabelNodes(nodes);
+}
+
+ImplicitStarfish::ImplicitStarfish(std::uint64_t nodes, std::uint64_t minRayLength, std::uint64_t numberOfRays)
+    : rayStart(nodes + 1, false) {
+    std::uint64_t start = 1;
+    for (auto length : rnd.partition(numberOfRays, nodes - 1, minRayLength)) {
+        // rays of length 0 (possible with minRayLength = 0) have no node to connect to
+        if (length == 0) {
+            continue;
+        }
+        rayStarts.push_back(start);
+        rayStart[start] = true;
+        start += length;
+    }
+    rayStart[nodes] = true;
+    relabelNodes(nodes);
+}
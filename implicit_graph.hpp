@@ -0,0 +1,208 @@
+#ifndef IMPLICIT_GRAPH_H_
+#define IMPLICIT_GRAPH_H_
+
+#include "graph.hpp"
+#include "graph_view.hpp"
+#include "instrument.hpp"
+#include "rand.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Base of graphs whose adjacency is a formula of the node id, stored as O(n) data instead of adjacency lists.
+ *
+ * `Derived` enumerates neighbours in its own numbering with `forEachOriginalNeighbor(v, f)`, where `f` returns false
+ * to stop, and the base applies a random relabeling drawn from `rnd`, exactly like `Graph::relabelNodes` does. Every
+ * view produces the same graph, with the same neighbour order, as the matching `Graph::construct*` for the same state
+ * of `rnd`, but printing it needs no adjacency lists, e.g. a clique on 50000 nodes prints in O(n) memory.
+ */
+template <typename Derived>
+class ImplicitGraph {
+public:
+    bool directed = false;
+
+    std::uint64_t getNumberOfNodes() const {
+        return perm.size();
+    }
+
+    std::uint64_t getDegree(std::uint64_t node) const {
+        return derived().getOriginalDegree(inverse[node]);
+    }
+
+    template <typename F>
+    void forEachNeighbor(std::uint64_t node, F &&f) const {
+        derived().forEachOriginalNeighbor(inverse[node], [&](std::uint64_t neighbour) {
+            return visitNeighbor(f, perm[neighbour]);
+        });
+    }
+
+    void printTo(std::ostream &outputStream, Graph::PrintFormat format, unsigned threads = 1) const {
+        TESTFRAME_SCOPED_TIMER("ImplicitGraph::printTo");
+        TESTFRAME_COUNT_BYTES_WRITTEN(outputStream);
+        printGraphTo(derived(), outputStream, format, threads);
+    }
+
+    // Materializes the adjacency lists.
+    Graph toGraph() const {
+        std::vector<std::vector<NodeId>> g(getNumberOfNodes());
+        for (std::uint64_t v = 0; v < getNumberOfNodes(); ++v) {
+            g[v].reserve(getDegree(v));
+            forEachNeighbor(v, [&](std::uint64_t u) {
+                g[v].push_back(u);
+            });
+        }
+        return Graph(std::move(g), directed);
+    }
+
+protected:
+    // Draws the relabeling, derived constructors call it after their own draws from `rnd`.
+    void relabelNodes(std::uint64_t nodes) {
+        perm = rnd.perm<NodeId>(nodes);
+        inverse.resize(nodes);
+        for (std::uint64_t v = 0; v < nodes; ++v) {
+            inverse[perm[v]] = v;
+        }
+    }
+
+private:
+    const Derived &derived() const {
+        return static_cast<const Derived &>(*this);
+    }
+
+    // new label of every original node and its inverse
+    std::vector<NodeId> perm;
+    std::vector<NodeId> inverse;
+};
+
+class ImplicitClique : public ImplicitGraph<ImplicitClique> {
+public:
+    explicit ImplicitClique(std::uint64_t nodes);
+
+    std::uint64_t getNumberOfEdges() const {
+        return nodes * (nodes - 1);
+    }
+
+    std::uint64_t getOriginalDegree(std::uint64_t) const {
+        return nodes - 1;
+    }
+
+    template <typename F>
+    void forEachOriginalNeighbor(std::uint64_t v, F &&f) const {
+        for (std::uint64_t u = 0; u < nodes; ++u) {
+            if (u != v && !f(u)) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::uint64_t nodes;
+};
+
+// Paths of random lengths, see `Graph::constructPathGraph`.
+class ImplicitPath : public ImplicitGraph<ImplicitPath> {
+public:
+    ImplicitPath(std::uint64_t nodes, std::uint64_t numberOfComponents = 1);
+
+    std::uint64_t getNumberOfEdges() const {
+        return 2 * (componentStart.size() - 1 - numberOfComponents);
+    }
+
+    std::uint64_t getOriginalDegree(std::uint64_t v) const {
+        return !componentStart[v] + !componentStart[v + 1];
+    }
+
+    template <typename F>
+    void forEachOriginalNeighbor(std::uint64_t v, F &&f) const {
+        if (!componentStart[v] && !f(v - 1)) {
+            return;
+        }
+        if (!componentStart[v + 1]) {
+            f(v + 1);
+        }
+    }
+
+private:
+    std::uint64_t numberOfComponents;
+    // componentStart[v] tells whether a path starts at v, with a sentinel at the end
+    std::vector<bool> componentStart;
+};
+
+// See `Graph::constructSilkwormGraph`.
+class ImplicitSilkworm : public ImplicitGraph<ImplicitSilkworm> {
+public:
+    explicit ImplicitSilkworm(std::uint64_t nodes);
+
+    std::uint64_t getNumberOfEdges() const {
+        return nodes == 0 ? 0 : 2 * (nodes - 1);
+    }
+
+    std::uint64_t getOriginalDegree(std::uint64_t v) const {
+        if (v % 2 == 1) {
+            return 1;
+        }
+        return (v >= 2) + (v + 1 < nodes) + (v + 2 < nodes);
+    }
+
+    template <typename F>
+    void forEachOriginalNeighbor(std::uint64_t v, F &&f) const {
+        if (v % 2 == 1) {
+            f(v - 1);
+            return;
+        }
+        if (v >= 2 && !f(v - 2)) {
+            return;
+        }
+        if (v + 1 < nodes && !f(v + 1)) {
+            return;
+        }
+        if (v + 2 < nodes) {
+            f(v + 2);
+        }
+    }
+
+private:
+    std::uint64_t nodes;
+};
+
+// Center 0 with rays of random lengths, see `Graph::constructStarfishGraph`.
+class ImplicitStarfish : public ImplicitGraph<ImplicitStarfish> {
+public:
+    ImplicitStarfish(std::uint64_t nodes, std::uint64_t minRayLength, std::uint64_t numberOfRays);
+
+    std::uint64_t getNumberOfEdges() const {
+        return 2 * (rayStart.size() - 2);
+    }
+
+    std::uint64_t getOriginalDegree(std::uint64_t v) const {
+        if (v == 0) {
+            return rayStarts.size();
+        }
+        return 1 + !rayStart[v + 1];
+    }
+
+    template <typename F>
+    void forEachOriginalNeighbor(std::uint64_t v, F &&f) const {
+        if (v == 0) {
+            for (auto start : rayStarts) {
+                if (!f(start)) {
+                    return;
+                }
+            }
+            return;
+        }
+        if (!f(rayStart[v] ? 0 : v - 1)) {
+            return;
+        }
+        if (!rayStart[v + 1]) {
+            f(v + 1);
+        }
+    }
+
+private:
+    std::vector<std::uint64_t> rayStarts;
+    // rayStart[v] tells whether a ray starts at v, with a sentinel at the end
+    std::vector<bool> rayStart;
+};
+
+#endif
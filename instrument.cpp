@@ -0,0 +1,267 @@
+#include "instrument.hpp"
+#include <sys/resource.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+
+namespace Instrumentation {
+
+namespace {
+
+constexpr std::array counterNames = {"bytesWritten", "rngDraws", "allocations", "allocatedBytes"};
+
+struct PhaseStats {
+    std::uint64_t calls = 0;
+    std::chrono::nanoseconds total{0};
+};
+
+struct TestRecord {
+    std::array<std::atomic<std::uint64_t>, counterNames.size()> counters{};
+    // transparent, so addPhase looks names up without building a string
+    std::map<std::string, PhaseStats, std::less<>> phases;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds wallTime{0};
+    std::uint64_t peakRssKb = 0;
+    bool finished = false;
+};
+
+std::mutex recordsMutex;
+// std::map keeps records at stable addresses, so threads can hold pointers to their current test.
+std::map<std::uint64_t, TestRecord> records;
+thread_local TestRecord *current = nullptr;
+// Bumped by `clear`, a thread's `current` is only valid while its generation matches.
+std::atomic<std::uint64_t> generation{0};
+thread_local std::uint64_t currentGeneration = 0;
+
+// The calling thread's record, or nullptr if it has none or `clear` freed it.
+TestRecord *currentRecord() {
+    if (current != nullptr && currentGeneration != generation.load(std::memory_order_acquire)) {
+        current = nullptr;
+    }
+    return current;
+}
+
+std::uint64_t peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::uint64_t>(usage.ru_maxrss);
+}
+
+void finish(TestRecord &record) {
+    if (!record.finished) {
+        record.finished = true;
+        record.wallTime = std::chrono::steady_clock::now() - record.start;
+        record.peakRssKb = peakRssKb();
+    }
+}
+
+void finishAll() {
+    for (auto &[testNumber, record] : records) {
+        finish(record);
+    }
+}
+
+std::string escapeCsv(const std::string &text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string escaped = "\"";
+    for (char c : text) {
+        escaped += c;
+        if (c == '"') {
+            escaped += '"';
+        }
+    }
+    return escaped + "\"";
+}
+
+}  // namespace
+
+void beginTest(std::uint64_t testNumber) {
+    std::lock_guard lock(recordsMutex);
+    if (TestRecord *previous = currentRecord()) {
+        finish(*previous);
+    }
+    // A regenerated test starts over, the record itself stays in place for threads that may still point to it.
+    TestRecord &record = records[testNumber];
+    for (auto &counter : record.counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    record.phases.clear();
+    record.start = std::chrono::steady_clock::now();
+    record.finished = false;
+    current = &record;
+    currentGeneration = generation.load(std::memory_order_relaxed);
+}
+
+void addCounter(Counter counter, std::uint64_t amount) {
+    if (TestRecord *record = currentRecord()) {
+        record->counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+void addPhase(const char *name, std::chrono::nanoseconds duration) {
+    if (current != nullptr) {
+        // Reports read the phase maps of all threads, counters are atomics and need no lock.
+        std::lock_guard lock(recordsMutex);
+        TestRecord *record = currentRecord();
+        if (record == nullptr) {
+            return;
+        }
+        auto found = record->phases.find(std::string_view(name));
+        if (found == record->phases.end()) {
+            found = record->phases.emplace(name, PhaseStats{}).first;
+        }
+        PhaseStats &stats = found->second;
+        ++stats.calls;
+        stats.total += duration;
+    }
+}
+
+void writeJson(std::ostream &outputStream) {
+    std::lock_guard lock(recordsMutex);
+    finishAll();
+    outputStream << "[\n";
+    bool firstRecord = true;
+    for (const auto &[testNumber, record] : records) {
+        outputStream << (firstRecord ? "" : ",\n") << "  {\"test\": " << testNumber
+                     << ", \"wallTimeNs\": " << record.wallTime.count() << ", \"peakRssKb\": " << record.peakRssKb;
+        for (std::size_t i = 0; i < counterNames.size(); ++i) {
+            outputStream << ", \"" << counterNames[i] << "\": " << record.counters[i].load();
+        }
+        outputStream << ", \"phases\": {";
+        bool firstPhase = true;
+        for (const auto &[name, stats] : record.phases) {
+            outputStream << (firstPhase ? "" : ", ") << std::quoted(name) << ": {\"calls\": " << stats.calls
+                         << ", \"totalNs\": " << stats.total.count() << "}";
+            firstPhase = false;
+        }
+        outputStream << "}}";
+        firstRecord = false;
+    }
+    outputStream << "\n]\n";
+}
+
+void writeCsv(std::ostream &outputStream) {
+    std::lock_guard lock(recordsMutex);
+    finishAll();
+    // One row per test and phase, test-level columns are repeated on every row of the test.
+    outputStream << "test,wallTimeNs,peakRssKb";
+    for (auto name : counterNames) {
+        outputStream << "," << name;
+    }
+    outputStream << ",phase,calls,totalNs\n";
+    for (const auto &[testNumber, record] : records) {
+        auto prefix = [&] {
+            outputStream << testNumber << "," << record.wallTime.count() << "," << record.peakRssKb;
+            for (const auto &counter : record.counters) {
+                outputStream << "," << counter.load();
+            }
+        };
+        if (record.phases.empty()) {
+            prefix();
+            outputStream << ",,,\n";
+        }
+        for (const auto &[name, stats] : record.phases) {
+            prefix();
+            outputStream << "," << escapeCsv(name) << "," << stats.calls << "," << stats.total.count() << "\n";
+        }
+    }
+}
+
+void writeReport(const std::filesystem::path &path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Could not open the file " << path << std::endl;
+        exit(1);
+    }
+    if (path.extension() == ".csv") {
+        writeCsv(file);
+    } else {
+        writeJson(file);
+    }
+}
+
+void clear() {
+    std::lock_guard lock(recordsMutex);
+    generation.fetch_add(1, std::memory_order_release);
+    records.clear();
+    current = nullptr;
+}
+
+}  // namespace Instrumentation
+
+#ifdef TESTFRAME_INSTRUMENT
+
+// Counting replacements of the global allocation functions. The nothrow forms of the standard library forward to
+// these, so every form of new is counted.
+void *operator new(std::size_t size) {
+    Instrumentation::addCounter(Instrumentation::Counter::Allocations, 1);
+    Instrumentation::addCounter(Instrumentation::Counter::AllocatedBytes, size);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    Instrumentation::addCounter(Instrumentation::Counter::Allocations, 1);
+    Instrumentation::addCounter(Instrumentation::Counter::AllocatedBytes, size);
+    // aligned_alloc takes sizes that are multiples of the alignment
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void *pointer = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef INSTRUMENT_H_
+#define INSTRUMENT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+
+/**
+ * @brief Optional per-test timing and counters for generators, printers and `setupTest`.
+ *
+ * Everything is compiled in only when TESTFRAME_INSTRUMENT is defined (CMake option TESTFRAME_INSTRUMENTATION),
+ * otherwise the macros below expand to nothing. Every `setupTest(n)` starts test `n` on the calling thread, and all
+ * phases and counters recorded by that thread are attributed to it until the next `setupTest`. Phase times are
+ * inclusive, e.g. `Graph::constructTreeGraph` contains the `Graph::relabelNodes` it calls.
+ *
+ * @code
+ * auto [prompt, solution] = setupTest(7);
+ * ...
+ * Instrumentation::writeReport("generation-report.json");  // or .csv
+ * @endcode
+ */
+namespace Instrumentation {
+
+enum class Counter {
+    BytesWritten,
+    RngDraws,
+    Allocations,
+    AllocatedBytes,
+};
+
+// Attributes everything the calling thread records from now on to test `testNumber`.
+void beginTest(std::uint64_t testNumber);
+
+void addCounter(Counter counter, std::uint64_t amount);
+
+void addPhase(const char *name, std::chrono::nanoseconds duration);
+
+// One record per test with wall time, phases, counters and the process peak RSS when the test ended.
+void writeJson(std::ostream &outputStream);
+void writeCsv(std::ostream &outputStream);
+// Picks CSV for a `.csv` extension and JSON otherwise.
+void writeReport(const std::filesystem::path &path);
+
+// Forgets all recorded tests. Threads in the middle of a test stop recording until their next `setupTest`. Counters
+// are added without the lock, so call it while no other thread is generating.
+void clear();
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char *name) : name(name), start(std::chrono::steady_clock::now()) {}
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    ~ScopedTimer() {
+        addPhase(name, std::chrono::steady_clock::now() - start);
+    }
+
+private:
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Adds the number of characters written to `outputStream` during its lifetime to `Counter::BytesWritten`.
+class ScopedBytesWritten {
+public:
+    explicit ScopedBytesWritten(std::ostream &outputStream) : outputStream(outputStream), start(outputStream.tellp()) {}
+
+    ScopedBytesWritten(const ScopedBytesWritten &) = delete;
+    ScopedBytesWritten &operator=(const ScopedBytesWritten &) = delete;
+
+    ~ScopedBytesWritten() {
+        auto end = outputStream.tellp();
+        if (start != std::streampos(-1) && end != std::streampos(-1)) {
+            addCounter(Counter::BytesWritten, static_cast<std::uint64_t>(end - start));
+        }
+    }
+
+private:
+    std::ostream &outputStream;
+    std::streampos start;
+};
+
+}  // namespace Instrumentation
+
+#define TESTFRAME_CONCAT_IMPL(a, b) a##b
+#define TESTFRAME_CONCAT(a, b) TESTFRAME_CONCAT_IMPL(a, b)
+
+#ifdef TESTFRAME_INSTRUMENT
+#define TESTFRAME_SCOPED_TIMER(name) \
+    ::Instrumentation::ScopedTimer TESTFRAME_CONCAT(testframeScopedTimer, __LINE__)(name)
+#define TESTFRAME_COUNT(counter, amount) \
+    ::Instrumentation::addCounter(::Instrumentation::Counter::counter, static_cast<std::uint64_t>(amount))
+#define TESTFRAME_BEGIN_TEST(testNumber) ::Instrumentation::beginTest(testNumber)
+#define TESTFRAME_COUNT_BYTES_WRITTEN(outputStream) \
+    ::Instrumentation::ScopedBytesWritten TESTFRAME_CONCAT(testframeBytesWritten, __LINE__)(outputStream)
+#else
+#define TESTFRAME_SCOPED_TIMER(name) static_cast<void>(0)
+#define TESTFRAME_COUNT(counter, amount) static_cast<void>(0)
+#define TESTFRAME_BEGIN_TEST(testNumber) static_cast<void>(0)
+#define TESTFRAME_COUNT_BYTES_WRITTEN(outputStream) static_cast<void>(0)
+#endif
+
+#endif
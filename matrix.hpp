@@ -2,7 +2,11 @@
 #define MATRIX_H_
 
 #include "utils.hpp"
+#include "format.hpp"
+#include "instrument.hpp"
+#include "rand.hpp"
 #include <cassert>
+#include <stdexcept>
 
 enum class MatrixPrintFormat { 
     Prompt,
@@ -16,35 +20,31 @@ public:
 
     using PrintFormat = MatrixPrintFormat;
 private:
-    void printForPromptTo(std::ostream &outputStream) const {
-        outputStream << "{";
-        for (std::uint64_t i = 0; i < getSize().first; ++i) {
-            outputStream << "{";
-            for (std::uint64_t j = 0; j < getSize().second; ++j) {
-                outputStream << matrix[i][j];
-                if (j != getSize().second - 1) {
-                    outputStream << ",";
-                }
-            }
-            outputStream << "}";
-            if (i != getSize().first - 1) {
-                outputStream << ",";
+    void printForPromptTo(std::ostream &outputStream, unsigned threads) const {
+        const auto [rows, columns] = getSize();
+        outputStream << '{';
+        printInParallel(outputStream, rows, threads, [columns](std::uint64_t) { return columns; },
+                        [&, rows](TextWriter &out, std::uint64_t i) {
+            out << '{';
+            out.appendJoined(matrix[i], ",");
+            out << '}';
+            if (i != rows - 1) {
+                out << ',';
             }
-        }
+        });
         outputStream << "}\n";
     }
 
-    void printForSolutionTo(std::ostream &outputStream) const {
-        outputStream << getSize().first << " " << getSize().second << "\n";
-        for (std::uint64_t i = 0; i < getSize().first; ++i) {
-            for (std::uint64_t j = 0; j < getSize().second; ++j) {
-                outputStream << matrix[i][j];
-                if (j != getSize().second - 1) {
-                    outputStream << " ";
-                }
-            }
-            outputStream << "\n";
+    void printForSolutionTo(std::ostream &outputStream, unsigned threads) const {
+        const auto [rows, columns] = getSize();
+        {
+            TextWriter out(outputStream);
+            out << rows << ' ' << columns << '\n';
         }
+        printInParallel(outputStream, rows, threads, [columns](std::uint64_t) { return columns; },
+                        [&](TextWriter &out, std::uint64_t i) {
+            out.appendJoined(matrix[i], " ") << '\n';
+        });
     }
 
     /// Checks if the vector of vectors is a valid matrix.
@@ -74,6 +74,11 @@ public:
         matrix = mat;
     }
 
+    // zero-filled matrix with `rows` rows and `columns` columns
+    Matrix(std::uint64_t rows, std::uint64_t columns) : matrix(rows, std::vector<T>(columns, T())) {
+        assert(rows > 0 && columns > 0);
+    }
+
     Matrix(const Matrix<T>& other) {
         matrix = other.matrix;
     }
@@ -105,19 +110,23 @@ public:
 
     operator std::vector<std::vector<T>>() const { return matrix; }
 
-    void printTo(std::ostream &outputStream, PrintFormat format) const {
+    // `threads` format row ranges in parallel, the output does not depend on it.
+    void printTo(std::ostream &outputStream, PrintFormat format, unsigned threads = 1) const {
+        TESTFRAME_SCOPED_TIMER("Matrix::printTo");
+        TESTFRAME_COUNT_BYTES_WRITTEN(outputStream);
         switch (format) {
             using enum PrintFormat;
             case Prompt:
-                printForPromptTo(outputStream);
+                printForPromptTo(outputStream, threads);
                 break;
             case Solution:
-                printForSolutionTo(outputStream);
+                printForSolutionTo(outputStream, threads);
                 break;
         }
     }
 
     static Matrix readMatrix(std::istream &inputStream) {
+        TESTFRAME_SCOPED_TIMER("Matrix::readMatrix");
         std::pair<std::uint64_t, std::uint64_t> size;
         inputStream >> size.first >> size.second;
         std::vector<std::vector<T>> matrix(size.first, std::vector<T>(size.second));
@@ -137,12 +146,61 @@ public:
         return Matrix(matrix);
     }
 
+    // `rows` x `columns` matrix of uniform values from [min, max]
+    static Matrix constructRandomMatrix(std::uint64_t rows, std::uint64_t columns, T min, T max) {
+        std::vector<std::vector<T>> matrix(rows);
+        for (auto &row : matrix) {
+            const auto values = rnd.intsFromRange(columns, min, max);
+            row.assign(values.begin(), values.end());
+        }
+        return Matrix(std::move(matrix));
+    }
+
     // Function to get the cofactor matrix (minor matrix)
-    Matrix getCofactor(std::uint64_t delRow, std::uint64_t delCol) const;
+    Matrix getCofactor(std::uint64_t delRow, std::uint64_t delCol) const {
+        std::uint64_t i = 0, j = 0;
+        std::vector<std::vector<T>> temp(getSize().first-1, std::vector<T>(getSize().second-1));
+        for (std::uint64_t row = 0; row < getSize().first; ++row) {
+            for (std::uint64_t col = 0; col < getSize().second; ++col) {
+                if (row != delRow && col != delCol) {
+                    temp[i][j++] = matrix[row][col];
+                    if (j == getSize().second - 1) {
+                        j = 0;
+                        ++i;
+                    }
+                }
+            }
+        }
+
+        return temp;
+    }
 
-    std::int64_t getTrace() const;
+    std::int64_t getTrace() const {
+        std::int64_t result = 0;
+        for (std::uint64_t i = 0; i < getSize().first; ++i) {
+            result += matrix[i][i];
+        }
+        return result;
+    }
 
-    std::int64_t getDeterminant() const;
+    std::int64_t getDeterminant() const {
+        assert(isSquareMatrix());
+
+        std::int64_t det = 0;
+        if (getSize().first == 1) {
+            return matrix[0][0];
+        }
+
+        std::int64_t sign = 1;
+
+        for (std::uint64_t f = 0; f < getSize().first; ++f) {
+            Matrix<T> temp = getCofactor(0, f);
+            det += sign * matrix[0][f] * temp.getDeterminant();
+            sign = -sign;
+        }
+
+        return det;
+    }
 
     Matrix<T> operator+(const Matrix<T>& other) const {
         if (getSize() != other.getSize()) {
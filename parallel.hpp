@@ -0,0 +1,50 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Number of worker threads to use for a request of `threads`, where 0 means "all hardware threads".
+inline unsigned resolveThreadCount(unsigned threads) {
+    if (threads != 0) {
+        return threads;
+    }
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+/**
+ * @brief Splits [begin, end) into at most `threads` contiguous chunks and runs `body(chunkBegin, chunkEnd, chunkIndex)`
+ * for every chunk, each on its own thread.
+ *
+ * Chunk lengths are multiples of `grain` (except for the last one), so with `grain` divisible by 64 no two chunks
+ * share a word of a bitmap indexed from `begin`. The last chunk runs on the calling thread and `chunkIndex` is always
+ * smaller than `resolveThreadCount(threads)`, so it can index per-thread buffers.
+ */
+template <typename F>
+void parallelForChunks(std::uint64_t begin, std::uint64_t end, unsigned threads, F &&body, std::uint64_t grain = 1024) {
+    if (begin >= end) {
+        return;
+    }
+    threads = resolveThreadCount(threads);
+    std::uint64_t chunk = (end - begin + threads - 1) / threads;
+    chunk = std::max<std::uint64_t>(1, (chunk + grain - 1) / grain) * grain;
+
+    std::vector<std::thread> workers;
+    unsigned index = 0;
+    for (std::uint64_t from = begin; from < end; from += chunk, ++index) {
+        std::uint64_t to = std::min(end, from + chunk);
+        if (to == end) {
+            body(from, to, index);
+            break;
+        }
+        workers.emplace_back([&body, from, to, index] { body(from, to, index); });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+#endif
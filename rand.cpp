@@ -1,20 +1,27 @@
 #include <cassert>
+#include <cmath>
+#include <map>
 
 #include "rand.hpp"
+#include "instrument.hpp"
+#include "parallel.hpp"
+#include <span>
 
 
-Random rnd{};
+thread_local Random rnd{};
 
 
 using IntType = Random::IntType;
 
 IntType Random::intFromRange(IntType a, IntType b) noexcept(false) {
+    TESTFRAME_COUNT(RngDraws, 1);
     assert(a <= b);
     std::uniform_int_distribution<IntType> dist(a, b);
     return dist(engine);
 }
 
 std::vector<IntType> Random::intsFromRange(std::size_t n, IntType a, IntType b) noexcept(false) {
+    TESTFRAME_COUNT(RngDraws, n);
     assert(a <= b);
     std::vector<IntType> ret(n);
     std::uniform_int_distribution<IntType> dist(a, b);
@@ -25,12 +32,14 @@ std::vector<IntType> Random::intsFromRange(std::size_t n, IntType a, IntType b)
 }
 
 double Random::doubleFromRange(double a, double b) noexcept(false) {
+    TESTFRAME_COUNT(RngDraws, 1);
     assert(std::isfinite(a) && std::isfinite(b) && a < b);
     std::uniform_real_distribution dist(a, b);
     return dist(engine);
 }
 
 std::vector<double> Random::doublesFromRange(std::size_t n, double a, double b) noexcept(false) {
+    TESTFRAME_COUNT(RngDraws, n);
     assert(std::isfinite(a) && std::isfinite(b) && a < b);
     std::vector<double> ret(n);
     std::uniform_real_distribution dist(a, b);
@@ -40,14 +49,8 @@ std::vector<double> Random::doublesFromRange(std::size_t n, double a, double b)
     return ret;
 }
 
-std::vector<IntType> Random::perm(std::size_t n, IntType a) noexcept {
-    std::vector<IntType> ret(n);
-    std::iota(std::begin(ret), std::end(ret), IntType{a});
-    std::shuffle(std::begin(ret), std::end(ret), engine);
-    return ret;
-}
-
 std::vector<IntType> Random::distinct(std::size_t n, IntType a, IntType b) noexcept(false) {
+    TESTFRAME_COUNT(RngDraws, n);
     assert(a <= static_cast<IntType>(b));
     assert(n <= static_cast<std::size_t>(b - a + 1));
     
@@ -61,31 +64,333 @@ std::vector<IntType> Random::distinct(std::size_t n, IntType a, IntType b) noexc
     return ret;
 }
 
-std::vector<IntType> Random::partition(std::size_t n, IntType sum, IntType min) noexcept(false) {
+namespace {
+
+// Partitions with fewer parts are composed in one piece, larger ones in groups of `partitionGroupSize` parts that run
+// in parallel. The groups depend only on the number of parts, never on the number of threads, so a seed gives the same
+// partition on every machine.
+constexpr std::size_t parallelPartitionThreshold = std::size_t{1} << 22;
+constexpr std::size_t partitionGroupSize = std::size_t{1} << 20;
+
+// Uniform weak composition of `total` into `parts.size()` non-negative parts. By stars and bars it corresponds to
+// choosing n - 1 bar positions among total + n - 1 slots, and SortedSampler yields those already sorted.
+void uniformWeakComposition(Random &random, std::span<IntType> parts, IntType total) {
+    const std::uint64_t n = parts.size();
+    SortedSampler bars(random, n - 1, static_cast<std::uint64_t>(total) + n - 1);
+    std::uint64_t previous = 0;
+    for (std::uint64_t i = 0; i + 1 < n; ++i) {
+        std::uint64_t bar = bars.next();
+        parts[i] = static_cast<IntType>(bar - previous);
+        previous = bar + 1;
+    }
+    parts[n - 1] = static_cast<IntType>(static_cast<std::uint64_t>(total) + n - 1 - previous);
+}
+
+// The sum of a group of `a` parts out of a + b is beta-binomial(total, a, b) distributed, so group sums are drawn
+// first and every group is then composed independently with its own engine, on as many threads as there are.
+void groupedUniformWeakComposition(Random &random, std::span<IntType> parts, IntType total) {
+    const std::uint64_t n = parts.size();
+    const std::uint64_t groups = (n + partitionGroupSize - 1) / partitionGroupSize;
+    std::vector<std::uint64_t> groupStart(groups + 1);
+    for (std::uint64_t g = 0; g <= groups; ++g) {
+        groupStart[g] = std::min<std::uint64_t>(n, g * partitionGroupSize);
+    }
+
+    std::vector<IntType> groupTotal(groups);
+    std::vector<std::uint64_t> seeds(groups);
+    IntType remainingTotal = total;
+    for (std::uint64_t g = 0; g < groups; ++g) {
+        std::uint64_t size = groupStart[g + 1] - groupStart[g];
+        std::uint64_t rest = n - groupStart[g + 1];
+        if (rest == 0) {
+            groupTotal[g] = remainingTotal;
+        } else {
+            std::gamma_distribution<double> groupShare(static_cast<double>(size)), restShare(static_cast<double>(rest));
+            double x = groupShare(random.engine), y = restShare(random.engine);
+            std::binomial_distribution<IntType> split(remainingTotal, x / (x + y));
+            groupTotal[g] = split(random.engine);
+        }
+        remainingTotal -= groupTotal[g];
+        seeds[g] = random.engine();
+    }
+
+    parallelForChunks(0, groups, 0, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+        for (std::uint64_t g = from; g < to; ++g) {
+            Random local(static_cast<IntType>(seeds[g]));
+            uniformWeakComposition(local, parts.subspan(groupStart[g], groupStart[g + 1] - groupStart[g]),
+                                   groupTotal[g]);
+        }
+    }, 1);
+}
+
+void weakComposition(Random &random, std::span<IntType> parts, IntType total) {
+    if (parts.size() >= parallelPartitionThreshold) {
+        groupedUniformWeakComposition(random, parts, total);
+    } else {
+        uniformWeakComposition(random, parts, total);
+    }
+}
+
+// Exact sampler for 0 <= parts[i] <= bounds[i] with sum `total`. ways[i][s] is proportional to the number of ways
+// parts i..n-1 can sum to s; rows are rescaled independently, which keeps the ratios needed for sampling.
+void boundedWeakCompositionByCounting(Random &random, std::span<IntType> parts, IntType total,
+                                      const std::vector<IntType> &bounds) {
+    const std::size_t n = parts.size();
+    const std::size_t width = static_cast<std::size_t>(total) + 1;
+    std::vector<double> ways((n + 1) * width, 0.0), prefix(width + 1);
+    ways[n * width] = 1.0;
+    for (std::size_t i = n; i-- > 0;) {
+        const double *below = &ways[(i + 1) * width];
+        double *row = &ways[i * width];
+        prefix[0] = 0.0;
+        for (std::size_t s = 0; s < width; ++s) {
+            prefix[s + 1] = prefix[s] + below[s];
+        }
+        double largest = 0.0;
+        for (std::size_t s = 0; s < width; ++s) {
+            std::size_t lowest = s > static_cast<std::size_t>(bounds[i]) ? s - bounds[i] : 0;
+            row[s] = std::max(0.0, prefix[s + 1] - prefix[lowest]);
+            largest = std::max(largest, row[s]);
+        }
+        if (largest > 0.0) {
+            for (std::size_t s = 0; s < width; ++s) {
+                row[s] /= largest;
+            }
+        }
+    }
+
+    std::size_t remaining = static_cast<std::size_t>(total);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double *below = &ways[(i + 1) * width];
+        std::size_t highest = std::min(remaining, static_cast<std::size_t>(bounds[i]));
+        double weight = 0.0;
+        for (std::size_t x = 0; x <= highest; ++x) {
+            weight += below[remaining - x];
+        }
+        double target = random.doubleFromRange(weight);
+        std::size_t x = 0;
+        while (x < highest && (target -= below[remaining - x]) >= 0.0) {
+            ++x;
+        }
+        parts[i] = static_cast<IntType>(x);
+        remaining -= x;
+    }
+}
+
+// Tables of the counting sampler are kept below this many entries.
+constexpr std::size_t countingLimit = std::size_t{1} << 24;
+
+// Mean of the geometric distribution with P(x) ~ exp(-lambda * x) truncated to 0..bound.
+double truncatedGeometricMean(double lambda, double bound) {
+    if (lambda * (bound + 1.0) < 1e-6) {
+        return bound / 2.0 - lambda * bound * (bound + 2.0) / 12.0;
+    }
+    return 1.0 / std::expm1(lambda) - (bound + 1.0) / std::expm1(lambda * (bound + 1.0));
+}
+
+IntType truncatedGeometric(Random &random, double lambda, IntType bound) {
+    if (lambda == 0.0) {
+        return random.intFromRange(0, bound);
+    }
+    double mass = -std::expm1(-lambda * (static_cast<double>(bound) + 1.0));
+    double x = -std::log1p(-random.doubleBetween01() * mass) / lambda;
+    return std::min(bound, static_cast<IntType>(x));
+}
+
+// ways[s] is proportional to the number of ways parts with `bounds` can sum to s, for s < width.
+std::vector<double> countWeakCompositions(std::span<const IntType> bounds, std::size_t width) {
+    std::vector<double> ways(width, 0.0), prefix(width + 1);
+    ways[0] = 1.0;
+    for (IntType bound : bounds) {
+        prefix[0] = 0.0;
+        for (std::size_t s = 0; s < width; ++s) {
+            prefix[s + 1] = prefix[s] + ways[s];
+        }
+        double largest = 0.0;
+        for (std::size_t s = 0; s < width; ++s) {
+            std::size_t lowest = s > static_cast<std::size_t>(bound) ? s - bound : 0;
+            ways[s] = std::max(0.0, prefix[s + 1] - prefix[lowest]);
+            largest = std::max(largest, ways[s]);
+        }
+        for (auto &value : ways) {
+            value /= largest;
+        }
+    }
+    return ways;
+}
+
+/**
+ * Exact sampler for 0 <= parts[i] <= bounds[i] with sum `total` that needs no table over all parts. The parts outside
+ * a tail block are drawn independently with P(x) ~ exp(-lambda * x), lambda chosen so the expected sum is `total`;
+ * conditioned on the sum every composition has the same weight exp(-lambda * total). The tail block takes the rest r
+ * with probability proportional to ways(r) * exp(-lambda * r), which corrects for the block not being drawn, and is
+ * then sampled by counting. The block is as large as the counting limit allows, so few draws get rejected.
+ */
+void boundedWeakCompositionByTilting(Random &random, std::span<IntType> parts, IntType total,
+                                     const std::vector<IntType> &bounds) {
+    const std::size_t n = parts.size();
+    IntType capacity = 0;
+    for (IntType bound : bounds) {
+        capacity = capacity > std::numeric_limits<IntType>::max() - bound ? std::numeric_limits<IntType>::max()
+                                                                          : capacity + bound;
+    }
+    // Drawing bound - x instead of x keeps lambda >= 0.
+    const bool complement = capacity < std::numeric_limits<IntType>::max() && total > capacity - total;
+    if (complement) {
+        total = capacity - total;
+    }
+
+    if (total == 0) {
+        for (std::size_t i = 0; i < n; ++i) {
+            parts[i] = complement ? bounds[i] : 0;
+        }
+        return;
+    }
+
+    // the block is parts[blockStart..n), blockWidth - 1 is the largest sum it can take that is at most `total`
+    std::size_t blockStart = n - 1;
+    std::size_t blockWidth = static_cast<std::size_t>(std::min(total, bounds[n - 1])) + 1;
+    while (blockStart > 0) {
+        std::size_t width = std::min(static_cast<std::size_t>(total),
+                                     blockWidth - 1 + static_cast<std::size_t>(std::min(total, bounds[blockStart - 1])))
+                            + 1;
+        if ((n - blockStart + 1) * width > countingLimit) {
+            break;
+        }
+        blockWidth = width;
+        --blockStart;
+    }
+    const std::span<const IntType> blockBounds(bounds.begin() + blockStart, bounds.end());
+
+    std::map<IntType, std::uint64_t> boundCounts;
+    for (IntType bound : bounds) {
+        ++boundCounts[bound];
+    }
+    auto expectedSum = [&](double lambda) {
+        double sum = 0.0;
+        for (auto [bound, count] : boundCounts) {
+            sum += static_cast<double>(count) * truncatedGeometricMean(lambda, static_cast<double>(bound));
+        }
+        return sum;
+    };
+    double low = 0.0, high = 1.0;
+    while (expectedSum(high) > static_cast<double>(total)) {
+        low = high;
+        high *= 2.0;
+    }
+    for (int iteration = 0; iteration < 100; ++iteration) {
+        double middle = (low + high) / 2.0;
+        (expectedSum(middle) > static_cast<double>(total) ? low : high) = middle;
+    }
+    const double lambda = high * (static_cast<double>(boundCounts.rbegin()->first) + 1.0) < 1e-9 ? 0.0 : high;
+
+    // The block takes the rest r with probability exp(logWeight[r] - largest). A single part can take every r up to
+    // its bound in one way, so its weight is exp(-lambda * r) and needs no table.
+    std::vector<double> logWeight;
+    double largest = 0.0;
+    if (blockStart + 1 < n) {
+        const auto ways = countWeakCompositions(blockBounds, blockWidth);
+        logWeight.resize(blockWidth);
+        for (std::size_t r = 0; r < blockWidth; ++r) {
+            logWeight[r] = std::log(ways[r]) - lambda * static_cast<double>(r);
+        }
+        largest = *std::max_element(logWeight.begin(), logWeight.end());
+    }
+    auto accept = [&](std::size_t r) {
+        double weight = logWeight.empty() ? -lambda * static_cast<double>(r) : logWeight[r];
+        return random.doubleBetween01() < std::exp(weight - largest);
+    };
+
+    IntType rest;
+    do {
+        rest = total;
+        for (std::size_t i = 0; i < blockStart && rest >= 0; ++i) {
+            parts[i] = truncatedGeometric(random, lambda, bounds[i]);
+            rest -= parts[i];
+        }
+    } while (rest < 0 || static_cast<std::size_t>(rest) >= blockWidth || !accept(static_cast<std::size_t>(rest)));
+
+    if (blockStart + 1 < n) {
+        boundedWeakCompositionByCounting(random, parts.subspan(blockStart), rest,
+                                         std::vector<IntType>(blockBounds.begin(), blockBounds.end()));
+    } else {
+        parts[n - 1] = rest;
+    }
+    if (complement) {
+        for (std::size_t i = 0; i < n; ++i) {
+            parts[i] = bounds[i] - parts[i];
+        }
+    }
+}
+
+}  // namespace
+
+std::vector<IntType> Random::partition(std::size_t n, IntType sum, IntType min, IntType max) noexcept(false) {
     if constexpr(std::is_signed_v<IntType>) {
         #pragma GCC diagnostic push
         #pragma GCC diagnostic ignored "-Wtype-limits"
         assert(sum >= 0 && min >= 0);
         #pragma GCC diagnostic pop
     }
+    assert(n > 0);
     assert(sum >= static_cast<Random::IntType>(n * min));
-    IntType adjusted_sum = sum - n * min;
-
-    std::vector<IntType> points = intsFromRange(n - 1, adjusted_sum - 1);
-    points.emplace_back(IntType{0});
-    points.emplace_back(adjusted_sum);
-    
-    std::sort(std::begin(points), std::end(points));
+    if (max < sum) {
+        return partition(sum, std::vector<IntType>(n, min), std::vector<IntType>(n, max));
+    }
 
     std::vector<IntType> partitions(n);
-    for(std::size_t i = 0; i < n; ++i) {
-        partitions[i] = points[i + 1] - points[i] + min;
+    weakComposition(*this, partitions, sum - static_cast<IntType>(n) * min);
+    for (auto &part : partitions) {
+        part += min;
     }
+    return partitions;
+}
+
+std::vector<IntType> Random::partition(IntType sum, const std::vector<IntType> &mins,
+                                       const std::vector<IntType> &maxs) noexcept(false) {
+    const std::size_t n = mins.size();
+    assert(n > 0 && maxs.size() == n);
+    IntType adjusted_sum = sum, capacity = 0;
+    std::vector<IntType> bounds(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(0 <= mins[i] && mins[i] <= maxs[i]);
+        adjusted_sum -= mins[i];
+        bounds[i] = maxs[i] - mins[i];
+        capacity = capacity > std::numeric_limits<IntType>::max() - bounds[i] ? std::numeric_limits<IntType>::max()
+                                                                               : capacity + bounds[i];
+    }
+    assert(0 <= adjusted_sum && adjusted_sum <= capacity);
 
-    return shuffle(partitions);
+    // Rejection keeps the distribution uniform and is fast unless the bounds are close to the average part, after a
+    // few failed attempts one of the exact samplers takes over.
+    std::vector<IntType> partitions(n);
+    constexpr int attemptsBeforeExact = 64;
+    for (int attempt = 0;; ++attempt) {
+        if (attempt == attemptsBeforeExact) {
+            if (n * (static_cast<std::size_t>(adjusted_sum) + 1) <= countingLimit) {
+                boundedWeakCompositionByCounting(*this, partitions, adjusted_sum, bounds);
+            } else {
+                boundedWeakCompositionByTilting(*this, partitions, adjusted_sum, bounds);
+            }
+            break;
+        }
+        weakComposition(*this, partitions, adjusted_sum);
+        bool fits = true;
+        for (std::size_t i = 0; i < n && fits; ++i) {
+            fits = partitions[i] <= bounds[i];
+        }
+        if (fits) {
+            break;
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        partitions[i] += mins[i];
+    }
+    return partitions;
 }
 
 [[nodiscard]] inline double Random::betaDist(double alpha, double beta) noexcept(false) {
+    TESTFRAME_COUNT(RngDraws, 2);
     assert(std::isfinite(alpha) && std::isfinite(beta));
     std::gamma_distribution<double> gamma_alpha(alpha, 1.0);
     std::gamma_distribution<double> gamma_beta(beta, 1.0);
@@ -102,3 +407,101 @@ std::vector<IntType> Random::partition(std::size_t n, IntType sum, IntType min)
     else
         return static_cast<IntType>((double)b * betaDist(1.0, -(double)type + 1.0)); 
 }
+
+
+SortedSampler::SortedSampler(Random &random, std::uint64_t count, std::uint64_t population) noexcept(false)
+    : random(random), remaining(count), population(population) {
+    assert(count <= population);
+}
+
+double SortedSampler::uniformOpenClosed() noexcept {
+    return 1.0 - random.doubleBetween01();
+}
+
+std::uint64_t SortedSampler::next() noexcept(false) {
+    TESTFRAME_COUNT(RngDraws, 1);
+    assert(hasNext());
+    // Method D only pays off while the sample is sparse, Vitter suggests switching at population < 13 * remaining.
+    std::uint64_t skip;
+    if (remaining == 1) {
+        skip = std::min(population - 1, static_cast<std::uint64_t>(population * random.doubleBetween01()));
+    } else if (remaining * 13 < population) {
+        skip = skipMethodD();
+    } else {
+        skip = skipMethodA();
+    }
+    std::uint64_t value = position + skip;
+    position = value + 1;
+    population -= skip + 1;
+    --remaining;
+    return value;
+}
+
+std::uint64_t SortedSampler::skipMethodA() noexcept {
+    double top = static_cast<double>(population - remaining);
+    double total = static_cast<double>(population);
+    double v = random.doubleBetween01();
+    double quot = top / total;
+    std::uint64_t skip = 0;
+    while (quot > v) {
+        ++skip;
+        top -= 1.0;
+        total -= 1.0;
+        quot *= top / total;
+    }
+    return skip;
+}
+
+std::uint64_t SortedSampler::skipMethodD() noexcept {
+    const double n = static_cast<double>(remaining);
+    const double total = static_cast<double>(population);
+    const std::uint64_t qu1 = population - remaining + 1;
+    const double qu1real = static_cast<double>(qu1);
+    const double nmin1inv = 1.0 / (n - 1.0);
+    if (vprimeFor != remaining) {
+        vprime = std::exp(std::log(uniformOpenClosed()) / n);
+    }
+
+    while (true) {
+        double x;
+        std::uint64_t skip;
+        while (true) {
+            x = total * (1.0 - vprime);
+            skip = static_cast<std::uint64_t>(x);
+            if (skip < qu1) {
+                break;
+            }
+            vprime = std::exp(std::log(uniformOpenClosed()) / n);
+        }
+
+        const double y1 = std::exp(std::log(uniformOpenClosed() * total / qu1real) * nmin1inv);
+        const double skipReal = static_cast<double>(skip);
+        vprime = y1 * (1.0 - x / total) * (qu1real / (qu1real - skipReal));
+        if (vprime <= 1.0) {
+            // quick acceptance, the rescaled value is a valid V' for the next step
+            vprimeFor = remaining - 1;
+            return skip;
+        }
+
+        double y2 = 1.0, top = total - 1.0, bottom;
+        std::uint64_t limit;
+        if (remaining - 1 > skip) {
+            bottom = total - n;
+            limit = population - skip;
+        } else {
+            bottom = total - skipReal - 1.0;
+            limit = qu1;
+        }
+        for (std::uint64_t t = population - 1; t >= limit; --t) {
+            y2 *= top / bottom;
+            top -= 1.0;
+            bottom -= 1.0;
+        }
+        if (total / (total - x) >= y1 * std::exp(std::log(y2) * nmin1inv)) {
+            vprime = std::exp(std::log(uniformOpenClosed()) * nmin1inv);
+            vprimeFor = remaining - 1;
+            return skip;
+        }
+        vprime = std::exp(std::log(uniformOpenClosed()) / n);
+    }
+}
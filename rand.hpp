@@ -8,7 +8,13 @@
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "instrument.hpp"
 
 
 struct [[nodiscard]] Random {
@@ -69,19 +75,28 @@ public:
         return doublesFromRange(n, 0.0, 1.0);
     }
 
-    // shuffled permutation of [a, a + n]
-    [[nodiscard]] std::vector<IntType> perm(std::size_t n, IntType a = 0) noexcept;
+    // shuffled permutation of [a, a + n), stored as `T`; the order does not depend on `T`
+    template <typename T = IntType>
+    [[nodiscard]] std::vector<T> perm(std::size_t n, std::type_identity_t<T> a = 0) noexcept {
+        TESTFRAME_COUNT(RngDraws, n);
+        std::vector<T> ret(n);
+        std::iota(std::begin(ret), std::end(ret), a);
+        std::shuffle(std::begin(ret), std::end(ret), engine);
+        return ret;
+    }
 
     // shuffle a range
     template<std::random_access_iterator I, std::sentinel_for<I> S>
     requires std::permutable<I>
     inline void shuffle(I first, S last) noexcept(false) {
+        TESTFRAME_COUNT(RngDraws, std::ranges::distance(first, last));
         std::shuffle(first, last, engine);
     }
     // shuffle a range
     template<std::ranges::random_access_range R>
     requires std::permutable<std::ranges::iterator_t<R>>
     inline auto& shuffle(R&& range) noexcept(false) {
+        TESTFRAME_COUNT(RngDraws, std::ranges::size(range));
         std::shuffle(std::begin(range), std::end(range), engine);
         return range;
     }
@@ -93,8 +108,14 @@ public:
         return distinct(n, IntType{0}, b);
     }
 
-    // returns a vector of `n` integers such that their sum is equal to `sum` and each of them is at least `min`
-    [[nodiscard]] std::vector<IntType> partition(std::size_t n, IntType sum, IntType min = 1)  noexcept(false);
+    // returns a vector of `n` integers such that their sum is equal to `sum` and each of them is in [min, max],
+    // chosen uniformly among all such vectors, in O(n) expected time when `max` is not restrictive
+    [[nodiscard]] std::vector<IntType> partition(std::size_t n, IntType sum, IntType min = 1,
+                                                 IntType max = std::numeric_limits<IntType>::max()) noexcept(false);
+    // uniform vector of `mins.size()` integers with sum `sum` and the i-th of them in [mins[i], maxs[i]];
+    // tight upper bounds are handled by rejection and, for small n * sum, by an exact O(n * sum) fallback
+    [[nodiscard]] std::vector<IntType> partition(IntType sum, const std::vector<IntType> &mins,
+                                                 const std::vector<IntType> &maxs) noexcept(false);
 
     // gets a double from beta distribution with parameters `alpha` and `beta`
     [[nodiscard]] inline double betaDist(double alpha, double beta) noexcept(false);
@@ -115,7 +136,38 @@ public:
     [[nodiscard]] IntType weightedNumFromRange(IntType b, std::int64_t type) noexcept(false);
 };
 
-extern Random rnd;
+// Every thread has its own generator, so generators can run on several threads at once. A new thread's `rnd` starts
+// from the default seed, so threads that are not seeded draw identical streams: code that uses `rnd` on worker
+// threads seeds it first, as `runTestPlan` does per test and `annealingSearch` does per chain. On the main thread
+// nothing changes. The access is as fast as a plain global (BM_IntFromRange vs BM_IntFromRangeLocal).
+extern thread_local Random rnd;
+
+
+// Draws `count` distinct integers from [0, population) in increasing order, one at a time.
+// Uses O(1) memory and O(count) expected time (Vitter's sequential sampling, method D with method A fallback).
+class SortedSampler {
+public:
+    SortedSampler(Random &random, std::uint64_t count, std::uint64_t population) noexcept(false);
+
+    [[nodiscard]] inline bool hasNext() const noexcept {
+        return remaining > 0;
+    }
+
+    // next sampled integer, larger than all previous ones
+    [[nodiscard]] std::uint64_t next() noexcept(false);
+
+private:
+    [[nodiscard]] double uniformOpenClosed() noexcept;
+    [[nodiscard]] std::uint64_t skipMethodA() noexcept;
+    [[nodiscard]] std::uint64_t skipMethodD() noexcept;
+
+    Random &random;
+    std::uint64_t remaining;
+    std::uint64_t population;
+    std::uint64_t position = 0;
+    double vprime = 0.0;
+    std::uint64_t vprimeFor = 0;
+};
 
 
 #endif // OLYMPIC_MINDS_TESTFRAME_RAND_HPP
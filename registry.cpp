@@ -0,0 +1,529 @@
+#include "registry.hpp"
+#include "checker.hpp"
+#include "format.hpp"
+#include "instrument.hpp"
+#include "rand.hpp"
+#include "tree.hpp"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace {
+
+Parameter count(std::string name, std::string description, std::optional<std::string> defaultValue = std::nullopt) {
+    return {std::move(name), ParameterType::Count, std::move(defaultValue), std::move(description)};
+}
+
+Parameter integer(std::string name, std::string description, std::optional<std::string> defaultValue = std::nullopt) {
+    return {std::move(name), ParameterType::Integer, std::move(defaultValue), std::move(description)};
+}
+
+Parameter real(std::string name, std::string description, std::optional<std::string> defaultValue = std::nullopt) {
+    return {std::move(name), ParameterType::Real, std::move(defaultValue), std::move(description)};
+}
+
+using Validator = std::function<std::string(const Arguments &)>;
+
+struct GraphGenerator {
+    std::string name;
+    std::vector<Parameter> parameters;
+    std::function<Graph(const Arguments &)> construct;
+    std::function<double(const Arguments &)> cost;
+    Validator validate = nullptr;
+};
+
+// cost of generators whose output is linear in the number of nodes
+double linear(const Arguments &args) {
+    return static_cast<double>(args.getCount("nodes"));
+}
+
+double quadratic(const Arguments &args) {
+    const auto nodes = static_cast<double>(args.getCount("nodes"));
+    return nodes * nodes / 2;
+}
+
+double grid(const Arguments &args) {
+    return 2.0 * static_cast<double>(args.getCount("rows")) * static_cast<double>(args.getCount("columns"));
+}
+
+std::string atLeastOneNode(const Arguments &args) {
+    return args.getCount("nodes") == 0 ? "'nodes' has to be at least 1" : "";
+}
+
+// `name` splits the nodes into that many non-empty parts
+Validator partsOfNodes(std::string name) {
+    return [name](const Arguments &args) -> std::string {
+        if (args.getCount(name) == 0 || args.getCount(name) > args.getCount("nodes")) {
+            return "'" + name + "' has to be between 1 and 'nodes'";
+        }
+        return {};
+    };
+}
+
+// `count` parts of at least `minLength` nodes each have to fit into `available` nodes
+bool fits(std::uint64_t count, std::uint64_t minLength, std::uint64_t available) {
+    return minLength == 0 || count <= available / minLength;
+}
+
+std::string atLeastOneRowAndColumn(const Arguments &args) {
+    return args.getCount("rows") == 0 || args.getCount("columns") == 0 ? "'rows' and 'columns' have to be at least 1"
+                                                                       : "";
+}
+
+std::vector<GraphGenerator> graphGenerators() {
+    const Parameter nodes = count("nodes", "number of nodes");
+    return {
+        {"constructEmptyGraph", {nodes},
+         [](const Arguments &a) { return Graph::constructEmptyGraph(a.getCount("nodes")); }, linear},
+        {"constructUndirectedClique", {nodes},
+         [](const Arguments &a) { return Graph::constructUndirectedClique(a.getCount("nodes")); }, quadratic},
+        {"constructPathGraph", {nodes, count("components", "number of paths", "1")},
+         [](const Arguments &a) { return Graph::constructPathGraph(a.getCount("nodes"), a.getCount("components")); },
+         linear, partsOfNodes("components")},
+        {"constructShallowForestGraph", {nodes, count("trees", "number of trees")},
+         [](const Arguments &a) {
+             return Graph::constructShallowForestGraph(a.getCount("nodes"), a.getCount("trees"));
+         },
+         linear, partsOfNodes("trees")},
+        {"constructShallowTreeGraph", {nodes},
+         [](const Arguments &a) { return Graph::constructShallowTreeGraph(a.getCount("nodes")); }, linear,
+         atLeastOneNode},
+        {"constructForestGraph", {nodes, count("trees", "number of trees")},
+         [](const Arguments &a) { return Graph::constructForestGraph(a.getCount("nodes"), a.getCount("trees")); },
+         linear, partsOfNodes("trees")},
+        {"constructTreeGraph", {nodes},
+         [](const Arguments &a) { return Graph::constructTreeGraph(a.getCount("nodes")); }, linear, atLeastOneNode},
+        {"constructSimplerJellyfishGraph",
+         {nodes, count("cycleSize", "length of the central cycle"),
+          count("minTentacleLength", "minimum length of a tentacle"), count("tentacles", "number of tentacles")},
+         [](const Arguments &a) {
+             return Graph::constructSimplerJellyfishGraph(a.getCount("nodes"), a.getCount("cycleSize"),
+                                                          a.getCount("minTentacleLength"), a.getCount("tentacles"));
+         },
+         linear,
+         [](const Arguments &a) -> std::string {
+             const auto nodes = a.getCount("nodes"), cycleSize = a.getCount("cycleSize");
+             if (cycleSize == 0 || cycleSize > nodes) {
+                 return "'cycleSize' has to be between 1 and 'nodes'";
+             }
+             if (a.getCount("tentacles") == 0 ||
+                 !fits(a.getCount("tentacles"), a.getCount("minTentacleLength"), nodes - cycleSize)) {
+                 return "there has to be at least one tentacle, and 'tentacles' * 'minTentacleLength' nodes besides "
+                        "the cycle";
+             }
+             return {};
+         }},
+        {"constructStarfishGraph",
+         {nodes, count("minRayLength", "minimum length of a ray"), count("rays", "number of rays")},
+         [](const Arguments &a) {
+             return Graph::constructStarfishGraph(a.getCount("nodes"), a.getCount("minRayLength"), a.getCount("rays"));
+         },
+         linear,
+         [](const Arguments &a) -> std::string {
+             if (a.getCount("nodes") == 0 || a.getCount("rays") == 0 ||
+                 !fits(a.getCount("rays"), a.getCount("minRayLength"), a.getCount("nodes") - 1)) {
+                 return "there has to be at least one ray, and 'rays' * 'minRayLength' nodes besides the center";
+             }
+             return {};
+         }},
+        {"constructSilkwormGraph", {nodes},
+         [](const Arguments &a) { return Graph::constructSilkwormGraph(a.getCount("nodes")); }, linear},
+        {"constructTreeOfBoundedDegreeGraph",
+         {nodes, count("minDegree", "minimum degree of inner nodes"), count("maxDegree", "maximum degree")},
+         [](const Arguments &a) {
+             return Graph::constructTreeOfBoundedDegreeGraph(a.getCount("nodes"), a.getCount("minDegree"),
+                                                             a.getCount("maxDegree"));
+         },
+         linear,
+         [](const Arguments &a) -> std::string {
+             const auto minDegree = a.getCount("minDegree");
+             // with a degree of 0 the tree can stop growing before it has all nodes
+             if (a.getCount("nodes") > 1 && (minDegree == 0 || minDegree > a.getCount("maxDegree"))) {
+                 return "'minDegree' has to be between 1 and 'maxDegree'";
+             }
+             return atLeastOneNode(a);
+         }},
+        {"constructSparseGraph", {nodes},
+         [](const Arguments &a) { return Graph::constructSparseGraph(a.getCount("nodes")); },
+         [](const Arguments &a) {
+             const auto n = static_cast<double>(a.getCount("nodes"));
+             return n * std::sqrt(n) / 2;
+         }},
+        {"constructDenseGraph", {nodes},
+         [](const Arguments &a) { return Graph::constructDenseGraph(a.getCount("nodes")); }, quadratic},
+        {"constructRandomDAG", {nodes, count("edges", "number of distinct edges"), count("height", "number of layers")},
+         [](const Arguments &a) {
+             return Graph::constructRandomDAG(a.getCount("nodes"), a.getCount("edges"), a.getCount("height"));
+         },
+         [](const Arguments &a) { return static_cast<double>(a.getCount("nodes") + a.getCount("edges")); },
+         [](const Arguments &a) -> std::string {
+             const auto nodes = a.getCount("nodes"), height = a.getCount("height");
+             if (height == 0 || height > nodes) {
+                 return "'height' has to be between 1 and 'nodes'";
+             }
+             // The layer sizes are random, the fewest pairs are left when one layer takes all but height - 1 nodes.
+             const std::uint64_t pairs = (nodes - height + 1) * (height - 1) + (height - 1) * (height - 2) / 2;
+             if (a.getCount("edges") > pairs) {
+                 return "'edges' can be at most " + std::to_string(pairs) + ", the number of pairs between layers "
+                        "when one layer takes all but 'height' - 1 nodes";
+             }
+             return {};
+         }},
+        {"constructRegularGraph", {nodes, count("degree", "degree of every node")},
+         [](const Arguments &a) { return Graph::constructRegularGraph(a.getCount("nodes"), a.getCount("degree")); },
+         [](const Arguments &a) { return static_cast<double>(a.getCount("nodes") * (a.getCount("degree") + 1)); },
+         [](const Arguments &a) -> std::string {
+             if (a.getCount("degree") >= a.getCount("nodes") || a.getCount("nodes") * a.getCount("degree") % 2 != 0) {
+                 return "'degree' has to be less than 'nodes', and 'nodes' * 'degree' even";
+             }
+             return {};
+         }},
+        {"constructBipartiteGraph",
+         {count("leftNodes", "nodes on the left side"), count("rightNodes", "nodes on the right side"),
+          real("probability", "probability of every edge between the sides")},
+         [](const Arguments &a) {
+             return Graph::constructBipartiteGraph(a.getCount("leftNodes"), a.getCount("rightNodes"),
+                                                   a.getReal("probability"));
+         },
+         [](const Arguments &a) {
+             const auto left = static_cast<double>(a.getCount("leftNodes"));
+             const auto right = static_cast<double>(a.getCount("rightNodes"));
+             return left + right + left * right * a.getReal("probability");
+         },
+         [](const Arguments &a) -> std::string {
+             return a.getReal("probability") >= 0.0 && a.getReal("probability") <= 1.0
+                        ? ""
+                        : "'probability' has to be between 0 and 1";
+         }},
+        {"constructBicliqueGraph",
+         {count("leftNodes", "nodes on the left side"), count("rightNodes", "nodes on the right side")},
+         [](const Arguments &a) {
+             return Graph::constructBicliqueGraph(a.getCount("leftNodes"), a.getCount("rightNodes"));
+         },
+         [](const Arguments &a) {
+             return static_cast<double>(a.getCount("leftNodes")) * static_cast<double>(a.getCount("rightNodes"));
+         }},
+        {"constructLatticeGraph", {count("rows", "number of rows"), count("columns", "number of columns")},
+         [](const Arguments &a) { return Graph::constructLatticeGraph(a.getCount("rows"), a.getCount("columns")); },
+         grid, atLeastOneRowAndColumn},
+        {"constructGridGraph", {count("rows", "number of rows"), count("columns", "number of columns")},
+         [](const Arguments &a) { return Graph::constructGridGraph(a.getCount("rows"), a.getCount("columns")); }, grid,
+         atLeastOneRowAndColumn},
+    };
+}
+
+// `Tree` generators, converted with `Tree::toGraph`
+std::vector<GraphGenerator> treeGenerators() {
+    const Parameter nodes = count("nodes", "number of nodes");
+    return {
+        {"constructRecursiveTree",
+         {nodes, integer("skew", "parent choice, 0 is uniform, > 0 favours recent nodes, < 0 early ones", "0")},
+         [](const Arguments &a) {
+             return Tree::constructRecursiveTree(a.getCount("nodes"), a.getInteger("skew")).toGraph();
+         },
+         linear, atLeastOneNode},
+        {"constructCaterpillarTree", {nodes, count("spineLength", "number of nodes on the central path")},
+         [](const Arguments &a) {
+             return Tree::constructCaterpillarTree(a.getCount("nodes"), a.getCount("spineLength")).toGraph();
+         },
+         linear, partsOfNodes("spineLength")},
+        {"constructKaryTree", {nodes, count("k", "children of every inner node")},
+         [](const Arguments &a) { return Tree::constructKaryTree(a.getCount("nodes"), a.getCount("k")).toGraph(); },
+         linear,
+         [](const Arguments &a) -> std::string {
+             return a.getCount("k") == 0 ? "'k' has to be at least 1" : atLeastOneNode(a);
+         }},
+        {"constructBoundedDegreeTree", {nodes, count("maxChildren", "most children of a node")},
+         [](const Arguments &a) {
+             return Tree::constructBoundedDegreeTree(a.getCount("nodes"), a.getCount("maxChildren")).toGraph();
+         },
+         linear,
+         [](const Arguments &a) -> std::string {
+             if (a.getCount("nodes") > 1 && a.getCount("maxChildren") == 0) {
+                 return "'maxChildren' has to be at least 1";
+             }
+             return atLeastOneNode(a);
+         }},
+    };
+}
+
+double sequenceLength(const Arguments &args) {
+    return static_cast<double>(args.getCount("n"));
+}
+
+// for generators with an inclusive range [`low`, `high`]
+Validator ordered(std::string low, std::string high) {
+    return [low, high](const Arguments &args) -> std::string {
+        if (args.getInteger(low) > args.getInteger(high)) {
+            return "'" + low + "' cannot be larger than '" + high + "'";
+        }
+        return {};
+    };
+}
+
+// Doubles are written with the precision of `outputStream`, like `operator<<` would.
+template <typename T>
+void printSequence(const std::vector<T> &values, std::ostream &outputStream, MatrixPrintFormat format) {
+    TESTFRAME_SCOPED_TIMER("printSequence");
+    TESTFRAME_COUNT_BYTES_WRITTEN(outputStream);
+    TextWriter out(outputStream);
+    if (format == MatrixPrintFormat::Prompt) {
+        out << '{';
+        out.appendJoined(values, ",") << "}\n";
+    } else {
+        out << values.size() << '\n';
+        out.appendJoined(values, " ") << '\n';
+    }
+}
+
+}  // namespace
+
+const std::vector<std::string> &getFormatNames(OutputKind kind) {
+    static const std::vector<std::string> graphFormats = {"PromptAdjecencyList", "SolutionAdjecencyList",
+                                                          "PromptAdjecencyMatrix", "SolutionAdjecencyMatrix"};
+    static const std::vector<std::string> listFormats = {"Prompt", "Solution"};
+    return kind == OutputKind::Graph || kind == OutputKind::WeightedGraph ? graphFormats : listFormats;
+}
+
+void printGeneratedTest(const GeneratedTest &test, std::ostream &outputStream, unsigned format, unsigned threads) {
+    std::visit(
+        [&](const auto &value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, Graph>) {
+                value.printTo(outputStream, static_cast<Graph::PrintFormat>(format), threads);
+            } else if constexpr (std::is_same_v<T, WeightedGraph>) {
+                value.printTo(outputStream, static_cast<WeightedGraph::PrintFormat>(format), threads);
+            } else if constexpr (std::is_same_v<T, Matrix<std::int64_t>>) {
+                value.printTo(outputStream, static_cast<MatrixPrintFormat>(format), threads);
+            } else {
+                printSequence(value, outputStream, static_cast<MatrixPrintFormat>(format));
+            }
+        },
+        test);
+}
+
+const std::string &Arguments::get(const std::string &name) const {
+    for (const auto &[key, value] : values) {
+        if (key == name) {
+            return value;
+        }
+    }
+    assert(false && "the generator has no such parameter");
+    static const std::string missing;
+    return missing;
+}
+
+std::uint64_t Arguments::getCount(const std::string &name) const {
+    return TokenReader::parse<std::uint64_t>(get(name)).value();
+}
+
+std::int64_t Arguments::getInteger(const std::string &name) const {
+    return TokenReader::parse<std::int64_t>(get(name)).value();
+}
+
+double Arguments::getReal(const std::string &name) const {
+    return TokenReader::parse<double>(get(name)).value();
+}
+
+std::optional<Arguments> Generator::bind(const std::map<std::string, std::string> &values, std::string &error) const {
+    for (const auto &[key, value] : values) {
+        bool known = false;
+        for (const auto &parameter : parameters) {
+            known = known || parameter.name == key;
+        }
+        if (!known) {
+            error = name + " has no parameter '" + key + "', expected " + signature();
+            return std::nullopt;
+        }
+    }
+    Arguments args;
+    for (const auto &parameter : parameters) {
+        auto given = values.find(parameter.name);
+        if (given == values.end() && !parameter.defaultValue) {
+            error = name + " needs the argument '" + parameter.name + "' (" + parameter.description + ")";
+            return std::nullopt;
+        }
+        const std::string &value = given != values.end() ? given->second : *parameter.defaultValue;
+        bool valid = false;
+        switch (parameter.type) {
+            case ParameterType::Count:
+                valid = TokenReader::parse<std::uint64_t>(value).has_value();
+                break;
+            case ParameterType::Integer:
+                valid = TokenReader::parse<std::int64_t>(value).has_value();
+                break;
+            case ParameterType::Real:
+                valid = TokenReader::parse<double>(value).has_value();
+                break;
+        }
+        if (!valid) {
+            static constexpr const char *expected[] = {"a non-negative integer", "an integer", "a number"};
+            error = "argument '" + parameter.name + "' of " + name + " has to be " +
+                    expected[static_cast<int>(parameter.type)] + ", found '" + value + "'";
+            return std::nullopt;
+        }
+        args.values.emplace_back(parameter.name, value);
+    }
+    if (validate) {
+        if (auto problem = validate(args); !problem.empty()) {
+            error = name + ": " + problem;
+            return std::nullopt;
+        }
+    }
+    return args;
+}
+
+std::string Generator::signature() const {
+    std::string result = name + '(';
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        if (i != 0) {
+            result += ", ";
+        }
+        result += parameters[i].name;
+        if (parameters[i].defaultValue) {
+            result += '=' + *parameters[i].defaultValue;
+        }
+    }
+    return result + ')';
+}
+
+void GeneratorRegistry::add(Generator generator) {
+    auto name = generator.name;
+    generators.insert_or_assign(std::move(name), std::move(generator));
+}
+
+const Generator *GeneratorRegistry::find(std::string_view name) const {
+    auto entry = generators.find(name);
+    return entry == generators.end() ? nullptr : &entry->second;
+}
+
+GeneratorRegistry GeneratorRegistry::builtin() {
+    GeneratorRegistry registry;
+    for (auto &graph : graphGenerators()) {
+        auto construct = graph.construct;
+        registry.add({"Graph::" + graph.name, OutputKind::Graph, graph.parameters,
+                      [construct](const Arguments &a) { return GeneratedTest(construct(a)); }, graph.cost,
+                      graph.validate});
+
+        auto parameters = graph.parameters;
+        parameters.push_back(integer("minWeight", "smallest edge weight", "1"));
+        parameters.push_back(integer("maxWeight", "largest edge weight", "1000000000"));
+        registry.add({"WeightedGraph::" + graph.name, OutputKind::WeightedGraph, std::move(parameters),
+                      [construct](const Arguments &a) {
+                          return GeneratedTest(WeightedGraph::addRandomWeights(construct(a), a.getInteger("minWeight"),
+                                                                               a.getInteger("maxWeight")));
+                      },
+                      graph.cost,
+                      [validate = graph.validate, weights = ordered("minWeight", "maxWeight")](const Arguments &a) {
+                          auto problem = validate ? validate(a) : "";
+                          if (problem.empty() && (!std::in_range<Weight>(a.getInteger("minWeight")) ||
+                                                  !std::in_range<Weight>(a.getInteger("maxWeight")))) {
+                              problem = "the weights have to fit in " + std::to_string(8 * sizeof(Weight)) + " bits";
+                          }
+                          return problem.empty() ? weights(a) : problem;
+                      }});
+    }
+
+    for (auto &tree : treeGenerators()) {
+        auto construct = tree.construct;
+        registry.add({"Tree::" + tree.name, OutputKind::Graph, tree.parameters,
+                      [construct](const Arguments &a) { return GeneratedTest(construct(a)); }, tree.cost,
+                      tree.validate});
+    }
+
+    using IntMatrix = Matrix<std::int64_t>;
+    registry.add({"Matrix::constructIdentityMatrix", OutputKind::Matrix, {count("size", "number of rows and columns")},
+                  [](const Arguments &a) {
+                      return GeneratedTest(IntMatrix::constructIdentityMatrix(a.getCount("size")));
+                  },
+                  [](const Arguments &a) {
+                      return static_cast<double>(a.getCount("size")) * static_cast<double>(a.getCount("size"));
+                  }});
+    registry.add({"Matrix::constructRandomMatrix", OutputKind::Matrix,
+                  {count("rows", "number of rows"), count("columns", "number of columns"),
+                   integer("min", "smallest value"), integer("max", "largest value")},
+                  [](const Arguments &a) {
+                      return GeneratedTest(IntMatrix::constructRandomMatrix(a.getCount("rows"), a.getCount("columns"),
+                                                                            a.getInteger("min"), a.getInteger("max")));
+                  },
+                  grid, ordered("min", "max")});
+
+    const Parameter n = count("n", "number of values");
+    registry.add({"Random::intsFromRange", OutputKind::Sequence,
+                  {n, integer("a", "smallest value"), integer("b", "largest value")},
+                  [](const Arguments &a) {
+                      return GeneratedTest(rnd.intsFromRange(a.getCount("n"), a.getInteger("a"), a.getInteger("b")));
+                  },
+                  sequenceLength, ordered("a", "b")});
+    registry.add({"Random::doublesFromRange", OutputKind::Sequence,
+                  {n, real("a", "smallest value"), real("b", "upper bound, exclusive")},
+                  [](const Arguments &a) {
+                      return GeneratedTest(rnd.doublesFromRange(a.getCount("n"), a.getReal("a"), a.getReal("b")));
+                  },
+                  sequenceLength,
+                  [](const Arguments &a) -> std::string {
+                      if (!std::isfinite(a.getReal("a")) || !std::isfinite(a.getReal("b")) ||
+                          a.getReal("a") >= a.getReal("b")) {
+                          return "'a' and 'b' have to be finite with 'a' < 'b'";
+                      }
+                      return {};
+                  }});
+    registry.add({"Random::perm", OutputKind::Sequence, {n, integer("a", "smallest value", "0")},
+                  [](const Arguments &a) {
+                      return GeneratedTest(rnd.perm<std::int64_t>(a.getCount("n"), a.getInteger("a")));
+                  },
+                  sequenceLength});
+    registry.add({"Random::distinct", OutputKind::Sequence,
+                  {n, integer("a", "smallest value"), integer("b", "largest value")},
+                  [](const Arguments &a) {
+                      return GeneratedTest(rnd.distinct(a.getCount("n"), a.getInteger("a"), a.getInteger("b")));
+                  },
+                  sequenceLength,
+                  [](const Arguments &a) -> std::string {
+                      // b - a is the number of values minus one, computed without overflowing
+                      const auto n = a.getCount("n");
+                      const auto span = static_cast<std::uint64_t>(a.getInteger("b")) -
+                                        static_cast<std::uint64_t>(a.getInteger("a"));
+                      if (a.getInteger("a") > a.getInteger("b") || (n > 0 && n - 1 > span)) {
+                          return "there have to be at least 'n' values between 'a' and 'b'";
+                      }
+                      return {};
+                  }});
+    registry.add({"Random::partition", OutputKind::Sequence,
+                  {n, integer("sum", "sum of the values"), integer("min", "smallest value", "1"),
+                   integer("max", "largest value", std::to_string(std::numeric_limits<Random::IntType>::max()))},
+                  [](const Arguments &a) {
+                      return GeneratedTest(rnd.partition(a.getCount("n"), a.getInteger("sum"), a.getInteger("min"),
+                                                         a.getInteger("max")));
+                  },
+                  sequenceLength,
+                  [](const Arguments &a) -> std::string {
+                      const auto n = static_cast<std::int64_t>(a.getCount("n"));
+                      const auto sum = a.getInteger("sum"), min = a.getInteger("min"), max = a.getInteger("max");
+                      if (n == 0 || min < 0 || min > max) {
+                          return "'n' has to be at least 1 and 0 <= 'min' <= 'max'";
+                      }
+                      // n * min <= sum <= n * max without overflowing
+                      if (sum < 0 || (min > 0 && n > sum / min) || max < sum / n + (sum % n != 0)) {
+                          return "'sum' has to be between 'n' * 'min' and 'n' * 'max'";
+                      }
+                      return {};
+                  }});
+    registry.add({"Random::weightedNumFromRange", OutputKind::Sequence,
+                  {n, integer("a", "smallest value"), integer("b", "upper bound, exclusive"),
+                   integer("type", "0 is uniform, t > 0 the maximum of t + 1 draws, t < 0 the minimum of 1 - t draws")},
+                  [](const Arguments &a) {
+                      std::vector<std::int64_t> values(a.getCount("n"));
+                      for (auto &value : values) {
+                          value = rnd.weightedNumFromRange(a.getInteger("a"), a.getInteger("b"), a.getInteger("type"));
+                      }
+                      return GeneratedTest(std::move(values));
+                  },
+                  sequenceLength,
+                  [](const Arguments &a) -> std::string {
+                      return a.getInteger("a") < a.getInteger("b") ? "" : "'a' has to be smaller than 'b'";
+                  }});
+    return registry;
+}
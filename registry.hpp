@@ -0,0 +1,124 @@
+#ifndef REGISTRY_H_
+#define REGISTRY_H_
+
+#include "graph.hpp"
+#include "matrix.hpp"
+#include "weighted_graph.hpp"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// What a generator produces, which decides the print formats it accepts.
+enum class OutputKind {
+    Graph,
+    WeightedGraph,
+    Matrix,
+    Sequence
+};
+
+/**
+ * @brief Names of the print formats of `kind`, indexed like the `PrintFormat` enum of the type. The first one is the
+ * default for prompt files and the second one the default for solution files.
+ *
+ * Graphs use the names of `GraphPrintFormat`, matrices and sequences `Prompt` (`{a,b,c}`) and `Solution` (the count,
+ * then the values).
+ */
+const std::vector<std::string> &getFormatNames(OutputKind kind);
+
+using GeneratedTest =
+    std::variant<Graph, WeightedGraph, Matrix<std::int64_t>, std::vector<std::int64_t>, std::vector<double>>;
+
+// Prints `test` in the format with index `format` of `getFormatNames`, formatting on `threads` threads.
+void printGeneratedTest(const GeneratedTest &test, std::ostream &outputStream, unsigned format, unsigned threads = 1);
+
+enum class ParameterType {
+    // non-negative integer, sizes and counts
+    Count,
+    Integer,
+    Real
+};
+
+struct Parameter {
+    std::string name;
+    ParameterType type;
+    // used when the argument is left out, required parameters have none
+    std::optional<std::string> defaultValue;
+    std::string description;
+};
+
+// Named arguments of one generator call, validated against its parameters by `Generator::bind`.
+class Arguments {
+public:
+    std::uint64_t getCount(const std::string &name) const;
+    std::int64_t getInteger(const std::string &name) const;
+    double getReal(const std::string &name) const;
+
+    // `name=value` pairs in parameter order, defaults included
+    const std::vector<std::pair<std::string, std::string>> &getValues() const {
+        return values;
+    }
+
+private:
+    friend struct Generator;
+
+    const std::string &get(const std::string &name) const;
+
+    std::vector<std::pair<std::string, std::string>> values;
+};
+
+struct Generator {
+    // the name of the C++ function, e.g. `Graph::constructTreeGraph`
+    std::string name;
+    OutputKind kind;
+    std::vector<Parameter> parameters;
+    // Builds the test from `rnd`, which the caller has seeded.
+    std::function<GeneratedTest(const Arguments &)> construct;
+    // Rough size of the output, only used to order tests, bigger ones first.
+    std::function<double(const Arguments &)> cost;
+    // Checks the preconditions of `construct` between arguments, returns what is wrong or an empty string. Generators
+    // that accept any arguments of the right types leave it empty.
+    std::function<std::string(const Arguments &)> validate = nullptr;
+
+    /**
+     * @brief Checks `values` (`name -> text`) against the parameters, fills in defaults and runs `validate`.
+     *
+     * @return the arguments, or `std::nullopt` with the reason in `error`
+     */
+    std::optional<Arguments> bind(const std::map<std::string, std::string> &values, std::string &error) const;
+
+    // `name(parameter=default, ...)` for listings
+    std::string signature() const;
+};
+
+/**
+ * @brief Generators by name, so tests can be described by data (see `test_plan.hpp`) instead of a `main` calling the
+ * `construct*` functions.
+ *
+ * `builtin()` registers every `Graph` generator, the same generators with random weights as `WeightedGraph::<name>`,
+ * the `Tree` generators (printed as graphs), the `Matrix` generators and the `Random` sequence functions.
+ * Problem-specific generators can be added with `add`.
+ */
+class GeneratorRegistry {
+public:
+    static GeneratorRegistry builtin();
+
+    // Replaces a generator with the same name.
+    void add(Generator generator);
+
+    const Generator *find(std::string_view name) const;
+
+    const std::map<std::string, Generator, std::less<>> &getGenerators() const {
+        return generators;
+    }
+
+private:
+    std::map<std::string, Generator, std::less<>> generators;
+};
+
+#endif
@@ -0,0 +1,503 @@
+// Determinism and performance regression checks for the generators.
+//
+// Every case seeds `rnd`, runs a generator and prints the result into a stream that only hashes what it is given.
+// `check` compares the hashes with the committed golden file, `regenerate` rewrites it after an intentional change
+// of the output (the diff of the golden file then documents which cases changed). `check-timings` compares running
+// CPU time and peak memory with a baseline recorded on the same machine by `record-timings`.
+//
+// Cases run one at a time in a forked child, so the peak memory of a case is not hidden by earlier ones and a crash
+// is reported with the name of the case.
+
+#include "edge_stream.hpp"
+#include "fingerprint.hpp"
+#include "graph.hpp"
+#include "implicit_graph.hpp"
+#include "matrix.hpp"
+#include "rand.hpp"
+#include "tree.hpp"
+#include "utils.hpp"
+#include "weighted_graph.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// Stream buffer that hashes everything written to it to 128 bits. Bytes are taken in little-endian 64-bit words of
+// fixed blocks, so the hash depends only on the bytes and not on how the printers split their writes.
+class HashingBuffer : public std::streambuf {
+public:
+    HashingBuffer() {
+        setp(block.data(), block.data() + block.size());
+    }
+
+    std::uint64_t getBytes() const {
+        return bytes + static_cast<std::uint64_t>(pptr() - pbase());
+    }
+
+    // 32 lowercase hex digits, call once after all output is written
+    std::string finish() {
+        absorbBlock();
+        absorb(bytes);
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string result;
+        for (auto part : {high, low}) {
+            for (int shift = 60; shift >= 0; shift -= 4) {
+                result += digits[(part >> shift) & 15];
+            }
+        }
+        return result;
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        absorbBlock();
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    void absorb(std::uint64_t word) {
+        low = mix(low ^ word);
+        high = mix(high ^ (word + 0x632be59bd9b4e019ULL) ^ (low << 17 | low >> 47));
+    }
+
+    void absorbBlock() {
+        const std::size_t size = static_cast<std::size_t>(pptr() - pbase());
+        for (std::size_t i = 0; i < size; i += 8) {
+            std::uint64_t word = 0;
+            for (std::size_t j = i; j < std::min(size, i + 8); ++j) {
+                word |= static_cast<std::uint64_t>(static_cast<unsigned char>(block[j])) << (8 * (j - i));
+            }
+            absorb(word);
+        }
+        bytes += size;
+        setp(block.data(), block.data() + block.size());
+    }
+
+    std::array<char, 1 << 16> block;
+    std::uint64_t bytes = 0;
+    std::uint64_t low = 0x6a09e667f3bcc908ULL;
+    std::uint64_t high = 0xbb67ae8584caa73bULL;
+};
+
+struct Case {
+    std::string name;
+    std::function<void(std::ostream &)> generate;
+};
+
+constexpr std::array<Random::IntType, 2> seeds = {1, 2};
+
+// Adds `generate` once per seed, named `name/seed=<seed>`.
+void addCase(std::vector<Case> &cases, const std::string &name, std::function<void(std::ostream &)> generate) {
+    for (auto seed : seeds) {
+        cases.push_back({name + "/seed=" + std::to_string(seed), [seed, generate](std::ostream &os) {
+                             rnd.setSeed(seed);
+                             generate(os);
+                         }});
+    }
+}
+
+template <typename Construct>
+void addGraphCase(std::vector<Case> &cases, const std::string &name, Construct construct,
+                  Graph::PrintFormat format = Graph::PrintFormat::SolutionAdjecencyList) {
+    addCase(cases, "Graph::" + name, [construct, format](std::ostream &os) { construct().printTo(os, format); });
+}
+
+// Prints every field, so a change of any invariant or of the refinement shows up as a changed case.
+void printFingerprint(std::ostream &os, const GraphFingerprint &f) {
+    os << f.directed << ' ' << f.numberOfNodes << ' ' << f.numberOfEdges << ' ' << f.triangles << ' ' << f.degreeHash
+       << ' ' << f.componentHash << ' ' << f.refinementHash << ' ' << f.getHash() << '\n';
+}
+
+std::string sized(std::string_view generator, std::uint64_t n) {
+    return std::string(generator) + "/n=" + std::to_string(n);
+}
+
+// The case matrix, sized so that the whole check takes a few seconds. Names are the keys of the golden file, so
+// renaming a case shows up as a removed and a new case.
+std::vector<Case> makeCases() {
+    using Format = Graph::PrintFormat;
+    std::vector<Case> cases;
+    for (std::uint64_t n : {1000, 100000}) {
+        addGraphCase(cases, sized("constructPathGraph", n), [n] { return Graph::constructPathGraph(n, 3); });
+        addGraphCase(cases, sized("constructShallowTreeGraph", n), [n] { return Graph::constructShallowTreeGraph(n); });
+        addGraphCase(cases, sized("constructShallowForestGraph", n),
+                     [n] { return Graph::constructShallowForestGraph(n, 10); });
+        addGraphCase(cases, sized("constructForestGraph", n), [n] { return Graph::constructForestGraph(n, 10); });
+        addGraphCase(cases, sized("constructTreeGraph", n), [n] { return Graph::constructTreeGraph(n); });
+        addGraphCase(cases, sized("constructTreeGraph", n) + "/PromptAdjecencyList",
+                     [n] { return Graph::constructTreeGraph(n); }, Format::PromptAdjecencyList);
+        addGraphCase(cases, sized("constructSimplerJellyfishGraph", n),
+                     [n] { return Graph::constructSimplerJellyfishGraph(n, 10, 5, 4); });
+        addGraphCase(cases, sized("constructStarfishGraph", n), [n] { return Graph::constructStarfishGraph(n, 3, 5); });
+        addGraphCase(cases, sized("constructSilkwormGraph", n), [n] { return Graph::constructSilkwormGraph(n); });
+        addGraphCase(cases, sized("constructTreeOfBoundedDegreeGraph", n),
+                     [n] { return Graph::constructTreeOfBoundedDegreeGraph(n, 1, 4); });
+        addGraphCase(cases, sized("constructRandomDAG", n), [n] { return Graph::constructRandomDAG(n, 4 * n, 10); });
+        addGraphCase(cases, sized("constructRegularGraph", n), [n] { return Graph::constructRegularGraph(n, 4); });
+        addGraphCase(cases, sized("relabelNodes", n), [n] { return Graph::constructPathGraph(n).relabelNodes(); });
+        addCase(cases, sized("Tree::constructRecursiveTree", n), [n](std::ostream &os) {
+            Tree::constructRecursiveTree(n).toGraph().printTo(os, Format::SolutionAdjecencyList);
+        });
+        addCase(cases, sized("Tree::constructRecursiveTree", n) + "/skew=3", [n](std::ostream &os) {
+            Tree::constructRecursiveTree(n, 3).toGraph().printTo(os, Format::SolutionAdjecencyList);
+        });
+        addCase(cases, sized("Tree::constructCaterpillarTree", n), [n](std::ostream &os) {
+            Tree::constructCaterpillarTree(n, n / 10).toGraph().printTo(os, Format::SolutionAdjecencyList);
+        });
+        addCase(cases, sized("Tree::constructKaryTree", n), [n](std::ostream &os) {
+            Tree::constructKaryTree(n, 3).toGraph().printTo(os, Format::SolutionAdjecencyList);
+        });
+        addCase(cases, sized("Tree::constructBoundedDegreeTree", n), [n](std::ostream &os) {
+            Tree::constructBoundedDegreeTree(n, 2).toGraph().printTo(os, Format::SolutionAdjecencyList);
+        });
+        addCase(cases, sized("ImplicitPath", n),
+                [n](std::ostream &os) { ImplicitPath(n, 3).printTo(os, Format::SolutionAdjecencyList); });
+        addCase(cases, sized("ImplicitSilkworm", n),
+                [n](std::ostream &os) { ImplicitSilkworm(n).printTo(os, Format::SolutionAdjecencyList); });
+        addCase(cases, sized("ImplicitStarfish", n),
+                [n](std::ostream &os) { ImplicitStarfish(n, 3, 5).printTo(os, Format::SolutionAdjecencyList); });
+        addCase(cases, sized("computeFingerprint", n) + "/constructTreeGraph",
+                [n](std::ostream &os) { printFingerprint(os, computeFingerprint(Graph::constructTreeGraph(n))); });
+        addCase(cases, sized("computeFingerprint", n) + "/constructRegularGraph",
+                [n](std::ostream &os) { printFingerprint(os, computeFingerprint(Graph::constructRegularGraph(n, 4))); });
+        addCase(cases, sized("computeFingerprint", n) + "/constructRandomDAG", [n](std::ostream &os) {
+            printFingerprint(os, computeFingerprint(Graph::constructRandomDAG(n, 4 * n, 10)));
+        });
+        addCase(cases, sized("WeightedGraph::addRandomWeights", n), [n](std::ostream &os) {
+            WeightedGraph::addRandomWeights(Graph::constructRandomDAG(n, 4 * n, 10), -1000, 1000)
+                .printTo(os, WeightedGraph::PrintFormat::SolutionAdjecencyList);
+        });
+        addCase(cases, sized("EdgeStream::constructTreeGraph", n),
+                [n](std::ostream &os) { EdgeStream::constructTreeGraph(n).writeTo(os); });
+        addCase(cases, sized("EdgeStream::constructRandomDAG", n),
+                [n](std::ostream &os) { EdgeStream::constructRandomDAG(n, 4 * n, 10).writeTo(os); });
+        addCase(cases, sized("Random::perm", n), [n](std::ostream &os) { os << rnd.perm(n) << '\n'; });
+        addCase(cases, sized("Random::intsFromRange", n),
+                [n](std::ostream &os) { os << rnd.intsFromRange(n, -1000000, 1000000) << '\n'; });
+        addCase(cases, sized("Random::distinct", n),
+                [n](std::ostream &os) { os << rnd.distinct(n, 0, 10 * n) << '\n'; });
+        addCase(cases, sized("Random::partition", n),
+                [n](std::ostream &os) { os << rnd.partition(n, 100 * n) << '\n'; });
+        // bounds this tight are rejected almost always, so it runs the exact bounded sampler
+        addCase(cases, sized("Random::partition", n) + "/bounded",
+                [n](std::ostream &os) { os << rnd.partition(n, 50 * n, 0, 100) << '\n'; });
+        addCase(cases, sized("Random::weightedNumFromRange", n), [n](std::ostream &os) {
+            for (std::uint64_t i = 0; i < n; ++i) {
+                os << rnd.weightedNumFromRange(1000, 3) << '\n';
+            }
+        });
+    }
+    // outputs growing faster than linearly get smaller sizes
+    for (std::uint64_t n : {1000, 5000}) {
+        addGraphCase(cases, sized("constructSparseGraph", n), [n] { return Graph::constructSparseGraph(n); });
+    }
+    for (std::uint64_t n : {30, 300}) {
+        addGraphCase(cases, sized("constructDenseGraph", n), [n] { return Graph::constructDenseGraph(n); });
+        addGraphCase(cases, sized("constructBipartiteGraph", n),
+                     [n] { return Graph::constructBipartiteGraph(n, 2 * n, 0.1); });
+        addGraphCase(cases, sized("constructGridGraph", n), [n] { return Graph::constructGridGraph(n, n); });
+        addGraphCase(cases, sized("constructLatticeGraph", n), [n] { return Graph::constructLatticeGraph(n, n); });
+        addGraphCase(cases, sized("constructRegularGraph", n) + "/SolutionAdjecencyMatrix",
+                     [n] { return Graph::constructRegularGraph(n, 4); }, Format::SolutionAdjecencyMatrix);
+        addCase(cases, sized("ImplicitClique", n),
+                [n](std::ostream &os) { ImplicitClique(n).printTo(os, Format::SolutionAdjecencyList); });
+        addCase(cases, sized("computeFingerprint", n) + "/constructDenseGraph",
+                [n](std::ostream &os) { printFingerprint(os, computeFingerprint(Graph::constructDenseGraph(n))); });
+        addCase(cases, sized("Matrix::constructIdentityMatrix", n), [n](std::ostream &os) {
+            Matrix<std::int64_t>::constructIdentityMatrix(n).printTo(os, MatrixPrintFormat::Solution);
+        });
+    }
+    return cases;
+}
+
+struct Measurement {
+    char hash[33];
+    std::uint64_t bytes;
+    std::uint64_t nanoseconds;
+    std::uint64_t peakRssKb;
+};
+
+// Runs the case in a forked child and reads back what it measured, exits if the child fails.
+Measurement measure(const Case &c) {
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        std::cerr << "Error: Could not create a pipe: " << std::strerror(errno) << std::endl;
+        exit(1);
+    }
+    std::cout.flush();
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+        std::cerr << "Error: Could not fork: " << std::strerror(errno) << std::endl;
+        exit(1);
+    }
+    if (pid == 0) {
+        ::close(fds[0]);
+        HashingBuffer buffer;
+        std::ostream os(&buffer);
+        c.generate(os);
+        os.flush();
+        Measurement m{};
+        m.bytes = buffer.getBytes();
+        const std::string hash = buffer.finish();
+        std::copy(hash.begin(), hash.end(), m.hash);
+        // CPU time rather than wall time, so other load on the machine disturbs the comparison less
+        rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+        for (const timeval &time : {usage.ru_utime, usage.ru_stime}) {
+            m.nanoseconds += static_cast<std::uint64_t>(time.tv_sec) * 1'000'000'000 +
+                             static_cast<std::uint64_t>(time.tv_usec) * 1000;
+        }
+        m.peakRssKb = static_cast<std::uint64_t>(usage.ru_maxrss);
+        const bool written = ::write(fds[1], &m, sizeof(m)) == static_cast<ssize_t>(sizeof(m));
+        ::_exit(written ? 0 : 1);
+    }
+    ::close(fds[1]);
+    Measurement m{};
+    std::size_t received = 0;
+    while (received < sizeof(m)) {
+        const ssize_t r = ::read(fds[0], reinterpret_cast<char *>(&m) + received, sizeof(m) - received);
+        if (r <= 0 && errno != EINTR) {
+            break;
+        }
+        received += r > 0 ? static_cast<std::size_t>(r) : 0;
+    }
+    ::close(fds[0]);
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    if (received != sizeof(m) || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "Error: case " << c.name << " failed";
+        if (WIFSIGNALED(status)) {
+            std::cerr << " with signal " << WTERMSIG(status) << " (" << ::strsignal(WTERMSIG(status)) << ")";
+        }
+        std::cerr << std::endl;
+        exit(1);
+    }
+    return m;
+}
+
+// Reads `name value...` lines, skipping empty lines and `#` comments.
+std::map<std::string, std::vector<std::string>> readTable(const std::string &path) {
+    std::ifstream file(path);
+    std::map<std::string, std::vector<std::string>> table;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string name, value;
+        fields >> name;
+        while (fields >> value) {
+            table[name].push_back(value);
+        }
+    }
+    return table;
+}
+
+void writeTable(const std::string &path, std::string_view header, const std::vector<std::string> &lines) {
+    std::ofstream file(path);
+    file << header;
+    for (const auto &line : lines) {
+        file << line << '\n';
+    }
+    if (!file) {
+        std::cerr << "Error: Could not write " << path << std::endl;
+        exit(1);
+    }
+}
+
+int regenerate(const std::vector<Case> &cases, const std::string &path) {
+    std::vector<std::string> lines;
+    for (const auto &c : cases) {
+        const auto m = measure(c);
+        lines.push_back(c.name + ' ' + m.hash + ' ' + std::to_string(m.bytes));
+    }
+    writeTable(path,
+               "# <case> <128-bit hash of the printed output> <bytes>\n"
+               "# Regenerate only for intentional output changes: cmake --build <build> --target regress_regenerate\n",
+               lines);
+    std::cout << "Wrote " << lines.size() << " hashes to " << path << std::endl;
+    return 0;
+}
+
+int check(const std::vector<Case> &cases, const std::string &path, bool filtered) {
+    auto golden = readTable(path);
+    if (golden.empty()) {
+        std::cerr << "Error: no golden hashes in " << path << std::endl;
+        return 1;
+    }
+    std::uint64_t failures = 0, matches = 0;
+    for (const auto &c : cases) {
+        const auto m = measure(c);
+        auto entry = golden.find(c.name);
+        if (entry == golden.end()) {
+            std::cout << "NEW      " << c.name << " has no golden hash" << std::endl;
+            ++failures;
+            continue;
+        }
+        if (entry->second.size() < 2 || entry->second[0] != m.hash || entry->second[1] != std::to_string(m.bytes)) {
+            std::cout << "CHANGED  " << c.name << ": " << m.hash << ' ' << m.bytes << " bytes, expected "
+                      << (entry->second.empty() ? "?" : entry->second[0]) << ' '
+                      << (entry->second.size() < 2 ? "?" : entry->second[1]) << " bytes" << std::endl;
+            ++failures;
+        } else {
+            ++matches;
+        }
+        golden.erase(entry);
+    }
+    if (!filtered) {
+        for (const auto &[name, values] : golden) {
+            std::cout << "REMOVED  " << name << " is in the golden file but not a case any more" << std::endl;
+            ++failures;
+        }
+    }
+    std::cout << matches << " of " << cases.size()
+              << " outputs match " << path << std::endl;
+    if (failures > 0) {
+        std::cout << "If the change is intentional, regenerate the golden file with the regress_regenerate target and "
+                     "commit it together with the change."
+                  << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+// Minimum over `repetitions` runs, the least noisy estimate of both time and memory.
+Measurement measureBest(const Case &c, unsigned repetitions) {
+    auto best = measure(c);
+    for (unsigned i = 1; i < repetitions; ++i) {
+        const auto m = measure(c);
+        best.nanoseconds = std::min(best.nanoseconds, m.nanoseconds);
+        best.peakRssKb = std::min(best.peakRssKb, m.peakRssKb);
+    }
+    return best;
+}
+
+int recordTimings(const std::vector<Case> &cases, const std::string &path, unsigned repetitions) {
+    std::vector<std::string> lines;
+    for (const auto &c : cases) {
+        const auto m = measureBest(c, repetitions);
+        lines.push_back(c.name + ' ' + std::to_string(m.nanoseconds) + ' ' + std::to_string(m.peakRssKb));
+    }
+    writeTable(path, "# <case> <nanoseconds> <peak RSS in KiB>, only comparable on the machine that recorded it\n",
+               lines);
+    std::cout << "Wrote " << lines.size() << " timings to " << path << std::endl;
+    return 0;
+}
+
+// Differences below these are noise no matter the threshold.
+constexpr std::uint64_t timeNoiseNanoseconds = 5'000'000;
+constexpr std::uint64_t memoryNoiseKb = 2048;
+
+int checkTimings(const std::vector<Case> &cases, const std::string &path, unsigned repetitions, double threshold) {
+    const auto baseline = readTable(path);
+    if (baseline.empty()) {
+        std::cout << "No timing baseline in " << path << ", record one with the regress_baseline target" << std::endl;
+        // skipped, see SKIP_RETURN_CODE in CMakeLists.txt
+        return 77;
+    }
+    auto exceeds = [threshold](std::uint64_t current, std::uint64_t base, std::uint64_t noise) {
+        return current > base + noise && static_cast<double>(current) > static_cast<double>(base) * (1 + threshold / 100);
+    };
+    std::uint64_t failures = 0;
+    for (const auto &c : cases) {
+        auto entry = baseline.find(c.name);
+        if (entry == baseline.end() || entry->second.size() < 2) {
+            std::cout << "SKIPPED  " << c.name << " has no baseline" << std::endl;
+            continue;
+        }
+        const std::uint64_t baseTime = std::stoull(entry->second[0]), baseMemory = std::stoull(entry->second[1]);
+        const auto m = measureBest(c, repetitions);
+        const bool slower = exceeds(m.nanoseconds, baseTime, timeNoiseNanoseconds);
+        const bool larger = exceeds(m.peakRssKb, baseMemory, memoryNoiseKb);
+        if (slower || larger) {
+            std::cout << (slower ? "SLOWER   " : "LARGER   ") << c.name << ": " << m.nanoseconds / 1000 << " us "
+                      << m.peakRssKb << " KiB, baseline " << baseTime / 1000 << " us " << baseMemory << " KiB"
+                      << std::endl;
+            ++failures;
+        }
+    }
+    std::cout << failures << " of " << cases.size() << " cases regressed by more than " << threshold << "%"
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int usage() {
+    std::cerr << "usage: testframe_regress <command> <file> [--filter <substring>] [--repetitions <k>] "
+                 "[--threshold <percent>]\n"
+                 "  check <golden>            fail if an output differs from its golden hash\n"
+                 "  regenerate <golden>       rewrite the golden hashes\n"
+                 "  check-timings <baseline>  fail if a case got slower or larger than the threshold\n"
+                 "  record-timings <baseline> rewrite the timing baseline\n";
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        return usage();
+    }
+    const std::string command = argv[1], path = argv[2];
+    std::string filter;
+    unsigned repetitions = 5;
+    double threshold = 50;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        const std::string_view option = argv[i];
+        if (option == "--filter") {
+            filter = argv[i + 1];
+        } else if (option == "--repetitions") {
+            repetitions = std::max(1, std::stoi(argv[i + 1]));
+        } else if (option == "--threshold") {
+            threshold = std::stod(argv[i + 1]);
+        } else {
+            return usage();
+        }
+    }
+
+    auto cases = makeCases();
+    std::erase_if(cases, [&](const Case &c) { return c.name.find(filter) == std::string::npos; });
+
+    if (command == "check") {
+        return check(cases, path, !filter.empty());
+    }
+    if (command == "regenerate") {
+        if (!filter.empty()) {
+            std::cerr << "Error: regenerate always rewrites all cases" << std::endl;
+            return 2;
+        }
+        return regenerate(cases, path);
+    }
+    if (command == "check-timings") {
+        return checkTimings(cases, path, repetitions, threshold);
+    }
+    if (command == "record-timings") {
+        return recordTimings(cases, path, repetitions);
+    }
+    return usage();
+}
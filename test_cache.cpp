@@ -0,0 +1,157 @@
+#include "test_cache.hpp"
+#include "instrument.hpp"
+#include "rand.hpp"
+#include "utils.hpp"
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+namespace {
+
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+std::filesystem::path testPath(const std::string &directoryName, std::uint64_t testNumber) {
+    return std::filesystem::path(dirs.at(directoryName)) / (std::to_string(testNumber) + ".in");
+}
+
+bool reflink(const std::filesystem::path &from, const std::filesystem::path &to) {
+#if defined(__linux__) && defined(FICLONE)
+    int source = open(from.c_str(), O_RDONLY);
+    if (source < 0) {
+        return false;
+    }
+    int target = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool cloned = target >= 0 && ioctl(target, FICLONE, source) == 0;
+    if (target >= 0) {
+        close(target);
+    }
+    close(source);
+    if (!cloned) {
+        std::error_code ignored;
+        std::filesystem::remove(to, ignored);
+    }
+    return cloned;
+#else
+    (void)from;
+    (void)to;
+    return false;
+#endif
+}
+
+// Makes `to` a hard link of `from`, falling back to a reflink and then to a plain copy (e.g. across file systems).
+void place(const std::filesystem::path &from, const std::filesystem::path &to) {
+    std::filesystem::remove(to);
+    std::error_code ec;
+    std::filesystem::create_hard_link(from, to, ec);
+    if (ec && !reflink(from, to)) {
+        std::filesystem::copy_file(from, to);
+    }
+}
+
+std::ofstream openForWriting(const std::filesystem::path &path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Could not open the file " << path << std::endl;
+        exit(1);
+    }
+    return file;
+}
+
+}  // namespace
+
+void CacheKey::addBytes(std::string_view tag, std::string_view bytes) {
+    auto absorb = [this](std::uint64_t word) {
+        low = mix(low ^ word);
+        high = mix(high ^ (word + 0x632be59bd9b4e019ULL) ^ (low << 17 | low >> 47));
+    };
+    for (auto part : {tag, bytes}) {
+        absorb(part.size());
+        for (std::size_t i = 0; i < part.size(); i += 8) {
+            std::uint64_t word = 0;
+            for (std::size_t j = i; j < std::min(part.size(), i + 8); ++j) {
+                word |= static_cast<std::uint64_t>(static_cast<unsigned char>(part[j])) << (8 * (j - i));
+            }
+            absorb(word);
+        }
+    }
+}
+
+void CacheKey::addRandomState() {
+    std::ostringstream state;
+    state << rnd.engine;
+    addBytes("rnd", state.str());
+}
+
+std::string CacheKey::hex() const {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string result;
+    for (auto part : {high, low}) {
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            result += digits[(part >> shift) & 15];
+        }
+    }
+    return result;
+}
+
+TestCache::TestCache(std::filesystem::path directory) : directory(std::move(directory)) {}
+
+bool TestCache::setupTest(std::uint64_t testNumber, const CacheKey &key, const Generator &generate) {
+    TESTFRAME_BEGIN_TEST(testNumber);
+    TESTFRAME_SCOPED_TIMER("TestCache::setupTest");
+    const auto entry = directory / key.hex();
+    const auto promptPath = testPath("promptInputDirectory", testNumber);
+    const auto solutionPath = testPath("solutionInputDirectory", testNumber);
+    // the cache places plain files, compressed ones from an earlier run would be left next to them
+    for (const auto &path : {promptPath, solutionPath}) {
+        std::filesystem::remove(std::filesystem::path(path) += ".gz");
+    }
+
+    // The state file is written last, an entry without it is never renamed into place.
+    std::ifstream state(entry / "rnd.state");
+    if (state >> rnd.engine) {
+        place(entry / "prompt.in", promptPath);
+        place(entry / "solution.in", solutionPath);
+        ++hits;
+        return true;
+    }
+    ++misses;
+
+    static std::atomic<std::uint64_t> temporaryCounter{0};
+    std::filesystem::create_directories(directory);
+    const auto temporary = directory / ("tmp-" + key.hex() + "-" + std::to_string(getpid()) + "-" +
+                                        std::to_string(temporaryCounter++));
+    std::filesystem::create_directory(temporary);
+    try {
+        {
+            auto promptFile = openForWriting(temporary / "prompt.in");
+            auto solutionFile = openForWriting(temporary / "solution.in");
+            generate(promptFile, solutionFile);
+        }
+        auto stateFile = openForWriting(temporary / "rnd.state");
+        stateFile << rnd.engine;
+    } catch (...) {
+        std::filesystem::remove_all(temporary);
+        throw;
+    }
+
+    // Renaming a directory is atomic; if another process stored the same entry first, keep theirs.
+    std::error_code ec;
+    std::filesystem::rename(temporary, entry, ec);
+    if (ec) {
+        std::filesystem::remove_all(temporary);
+    }
+    place(entry / "prompt.in", promptPath);
+    place(entry / "solution.in", solutionPath);
+    return false;
+}
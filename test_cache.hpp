@@ -0,0 +1,110 @@
+#ifndef TEST_CACHE_H_
+#define TEST_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Hash of regress/golden.txt, set by the build. Regenerating the golden hashes after a generator changes its output
+// changes every cache key, so stale entries are never hit.
+#ifndef TESTFRAME_GOLDEN_HASH
+#define TESTFRAME_GOLDEN_HASH ""
+#endif
+
+// Part of every cache key together with TESTFRAME_GOLDEN_HASH. Bump it when the output changes for inputs the
+// regression cases do not cover, which leaves the golden hashes as they are.
+inline constexpr std::string_view cacheFormatVersion = "testframe-4";
+
+/**
+ * @brief Identity of a generated test: generator name, its arguments, the current state of `rnd`,
+ * `cacheFormatVersion` and TESTFRAME_GOLDEN_HASH, hashed to 128 bits.
+ *
+ * The state of `rnd` is captured when the key is constructed, so construct it right before generating the test.
+ */
+class CacheKey {
+public:
+    template <typename... Args>
+    explicit CacheKey(std::string_view generator, const Args &...args) {
+        addBytes("version", cacheFormatVersion);
+        addBytes("golden", TESTFRAME_GOLDEN_HASH);
+        addBytes("generator", generator);
+        addRandomState();
+        (add(args), ...);
+    }
+
+    CacheKey &add(std::string_view value) {
+        addBytes("string", value);
+        return *this;
+    }
+
+    CacheKey &add(const char *value) {
+        return add(std::string_view(value));
+    }
+
+    CacheKey &add(const std::string &value) {
+        return add(std::string_view(value));
+    }
+
+    template <typename T>
+    requires std::is_arithmetic_v<T>
+    CacheKey &add(T value) {
+        addBytes(std::is_floating_point_v<T> ? "float" : "int",
+                 std::string_view(reinterpret_cast<const char *>(&value), sizeof(value)));
+        return *this;
+    }
+
+    // 32 lowercase hex digits
+    std::string hex() const;
+
+private:
+    void addBytes(std::string_view tag, std::string_view bytes);
+    void addRandomState();
+
+    std::uint64_t low = 0x6a09e667f3bcc908ULL;
+    std::uint64_t high = 0xbb67ae8584caa73bULL;
+};
+
+/**
+ * @brief On-disk cache of generated tests, keyed by `CacheKey`.
+ *
+ * Every entry holds the prompt and solution input files and the state `rnd` was left in after generating them.
+ * On a hit the cached files are hard-linked (or reflinked, or copied as a last resort) into the test directories and
+ * `rnd` is restored, so the tests after it see exactly the same random state as without the cache. On a miss the test
+ * is generated into a temporary directory that is atomically renamed into the cache.
+ *
+ * @note Files in `in/` and `solution-in/` may share storage with the cache, so they must be replaced rather than
+ * modified in place; `setupTest` removes a previous file before opening a new one.
+ */
+class TestCache {
+public:
+    using Generator = std::function<void(std::ostream &promptInput, std::ostream &solutionInput)>;
+
+    explicit TestCache(std::filesystem::path directory = ".testframe-cache");
+
+    /**
+     * @brief Produces test `testNumber` in the prompt and solution input directories, reusing the cache entry for `key`
+     * if there is one and calling `generate` otherwise.
+     *
+     * @return true on a cache hit
+     */
+    bool setupTest(std::uint64_t testNumber, const CacheKey &key, const Generator &generate);
+
+    std::uint64_t getHits() const {
+        return hits;
+    }
+
+    std::uint64_t getMisses() const {
+        return misses;
+    }
+
+private:
+    std::filesystem::path directory;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include "test_plan.hpp"
+#include "checker.hpp"
+#include "parallel.hpp"
+#include "test_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+
+namespace {
+
+[[noreturn]] void planError(const std::string &source, std::uint64_t line, const std::string &message) {
+    std::cerr << "Error: " << source << ":" << line << ": " << message << std::endl;
+    exit(1);
+}
+
+// Index of `name` among the formats of `kind`.
+std::optional<unsigned> findFormat(OutputKind kind, const std::string &name) {
+    const auto &names = getFormatNames(kind);
+    auto found = std::find(names.begin(), names.end(), name);
+    if (found == names.end()) {
+        return std::nullopt;
+    }
+    return static_cast<unsigned>(found - names.begin());
+}
+
+std::string joinFormats(OutputKind kind) {
+    std::string result;
+    for (const auto &name : getFormatNames(kind)) {
+        result += (result.empty() ? "" : ", ") + name;
+    }
+    return result;
+}
+
+}  // namespace
+
+std::vector<PlannedTest> readTestPlan(std::istream &inputStream, const GeneratorRegistry &registry,
+                                      const std::string &source, std::uint64_t firstTestNumber) {
+    std::vector<PlannedTest> tests;
+    std::string text;
+    for (std::uint64_t line = 1; std::getline(inputStream, text); ++line) {
+        text = text.substr(0, text.find('#'));
+        std::istringstream tokens(text);
+        std::string name;
+        if (!(tokens >> name)) {
+            continue;
+        }
+        const Generator *generator = registry.find(name);
+        if (generator == nullptr) {
+            planError(source, line, "unknown generator '" + name + "'");
+        }
+
+        std::map<std::string, std::string> values;
+        std::string token;
+        while (tokens >> token) {
+            const auto separator = token.find('=');
+            if (separator == std::string::npos || separator == 0) {
+                planError(source, line, "expected name=value, found '" + token + "'");
+            }
+            const std::string key = token.substr(0, separator);
+            if (!values.emplace(key, token.substr(separator + 1)).second) {
+                planError(source, line, "'" + key + "' is given twice");
+            }
+        }
+
+        PlannedTest test{firstTestNumber + tests.size(), generator, {}, 0, 0, 1, 0, line};
+        test.seed = static_cast<Random::IntType>(test.testNumber);
+        if (auto seed = values.extract("seed")) {
+            auto parsed = TokenReader::parse<Random::IntType>(seed.mapped());
+            if (!parsed) {
+                planError(source, line, "the seed has to be an integer, found '" + seed.mapped() + "'");
+            }
+            test.seed = *parsed;
+        }
+        const std::pair<const char *, unsigned *> formats[] = {{"prompt", &test.promptFormat},
+                                                               {"solution", &test.solutionFormat}};
+        for (auto [key, format] : formats) {
+            if (auto value = values.extract(key)) {
+                auto index = findFormat(generator->kind, value.mapped());
+                if (!index) {
+                    planError(source, line, "unknown " + std::string(key) + " format '" + value.mapped() + "' for " +
+                                                name + ", expected one of " + joinFormats(generator->kind));
+                }
+                *format = *index;
+            }
+        }
+
+        std::string error;
+        auto arguments = generator->bind(values, error);
+        if (!arguments) {
+            planError(source, line, error);
+        }
+        test.arguments = std::move(*arguments);
+        test.cost = generator->cost(test.arguments);
+        tests.push_back(std::move(test));
+    }
+    return tests;
+}
+
+std::vector<const PlannedTest *> scheduleTestPlan(const std::vector<PlannedTest> &tests) {
+    // Longest processing time first: with the big tests started early, the small ones fill up the gaps at the end.
+    std::vector<const PlannedTest *> order;
+    order.reserve(tests.size());
+    for (const auto &test : tests) {
+        order.push_back(&test);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const PlannedTest *a, const PlannedTest *b) { return a->cost > b->cost; });
+    return order;
+}
+
+PlanSummary runTestPlan(const std::vector<PlannedTest> &tests, const PlanOptions &options) {
+    const bool cached = !options.cacheDirectory.empty();
+    if (cached && (options.output.compress || options.output.asyncWrite)) {
+        std::cerr << "Error: the test cache stores plain files, it cannot be combined with compressed or asynchronous "
+                     "output"
+                  << std::endl;
+        exit(1);
+    }
+
+    const auto order = scheduleTestPlan(tests);
+    const unsigned jobs = static_cast<unsigned>(std::min<std::size_t>(resolveThreadCount(options.jobs), order.size()));
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::uint64_t> hits{0};
+    // one chunk per worker, each worker takes the next test in `order` whenever it is done with one
+    parallelForChunks(0, jobs, jobs, [&](std::uint64_t, std::uint64_t, unsigned) {
+        std::optional<TestCache> cache;
+        if (cached) {
+            cache.emplace(options.cacheDirectory);
+        }
+        for (std::size_t i = next++; i < order.size(); i = next++) {
+            const PlannedTest &test = *order[i];
+            rnd.setSeed(test.seed);
+            auto generate = [&](std::ostream &prompt, std::ostream &solution) {
+                const auto generated = test.generator->construct(test.arguments);
+                printGeneratedTest(generated, prompt, test.promptFormat, options.printThreads);
+                printGeneratedTest(generated, solution, test.solutionFormat, options.printThreads);
+            };
+            if (cache) {
+                const auto &formats = getFormatNames(test.generator->kind);
+                CacheKey key(test.generator->name, formats[test.promptFormat], formats[test.solutionFormat]);
+                for (const auto &[name, value] : test.arguments.getValues()) {
+                    key.add(name + '=' + value);
+                }
+                hits += cache->setupTest(test.testNumber, key, generate) ? 1 : 0;
+            } else {
+                auto [prompt, solution] = setupTest(test.testNumber, options.output);
+                generate(*prompt, *solution);
+            }
+        }
+    }, 1);
+    return {tests.size(), hits};
+}
@@ -0,0 +1,76 @@
+#ifndef TEST_PLAN_H_
+#define TEST_PLAN_H_
+
+#include "gen_utils.hpp"
+#include "rand.hpp"
+#include "registry.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <string>
+#include <vector>
+
+struct PlannedTest {
+    std::uint64_t testNumber;
+    const Generator *generator;
+    Arguments arguments;
+    Random::IntType seed;
+    // indices into `getFormatNames(generator->kind)`
+    unsigned promptFormat;
+    unsigned solutionFormat;
+    // `generator->cost(arguments)`
+    double cost;
+    // where the test was declared, for messages
+    std::uint64_t line;
+};
+
+/**
+ * @brief Reads a test plan: one test per line, numbered from `firstTestNumber` in the order of the lines.
+ *
+ * A line names a generator of `registry` followed by `name=value` arguments. Besides the generator's parameters,
+ * `seed` seeds `rnd` for the test (the test number by default), and `prompt` and `solution` choose the print formats
+ * of the two files by name, see `getFormatNames`. Empty lines and everything after `#` are ignored:
+ *
+ * @code
+ * # the first three tests of a shortest path problem
+ * WeightedGraph::constructPathGraph nodes=10 minWeight=1 maxWeight=5
+ * WeightedGraph::constructRandomDAG nodes=100000 edges=1000000 height=50 seed=7
+ * WeightedGraph::constructGridGraph rows=300 columns=300 solution=SolutionAdjecencyMatrix
+ * @endcode
+ *
+ * Errors are reported on `std::cerr` with `source` and the line number and end the program.
+ */
+std::vector<PlannedTest> readTestPlan(std::istream &inputStream, const GeneratorRegistry &registry,
+                                      const std::string &source = "test plan", std::uint64_t firstTestNumber = 1);
+
+struct PlanOptions {
+    // tests generated at the same time, 0 uses all hardware threads
+    unsigned jobs = 0;
+    // threads formatting each file, see `printInParallel`
+    unsigned printThreads = 1;
+    // how the files are written when the cache is not used
+    OutputOptions output;
+    // directory of a `TestCache` to reuse tests from, empty to always generate
+    std::filesystem::path cacheDirectory;
+};
+
+struct PlanSummary {
+    std::uint64_t tests = 0;
+    std::uint64_t cacheHits = 0;
+};
+
+// The order `runTestPlan` starts the tests in: biggest `cost` first, ties in plan order.
+std::vector<const PlannedTest *> scheduleTestPlan(const std::vector<PlannedTest> &tests);
+
+/**
+ * @brief Generates all `tests` into the prompt and solution input directories, which have to exist.
+ *
+ * Tests run on `options.jobs` threads in the order of `scheduleTestPlan`, so a large test is not left to run alone at
+ * the end. Every test seeds the `rnd` of the thread it runs on, so its files do not depend on the schedule. Each test
+ * is started with `setupTest`, which attributes it in the instrumentation report, or taken from the cache if
+ * `options.cacheDirectory` is set (the cache stores plain files, so compressed or asynchronous `options.output` is an
+ * error then and exits).
+ */
+PlanSummary runTestPlan(const std::vector<PlannedTest> &tests, const PlanOptions &options = {});
+
+#endif
@@ -0,0 +1,244 @@
+#include "traversal.hpp"
+#include "csr_graph.hpp"
+#include "dynamic_graph.hpp"
+#include "implicit_graph.hpp"
+#include "parallel.hpp"
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <memory>
+
+namespace {
+
+// Heuristic constants from Beamer et al., "Direction-Optimizing Breadth-First Search".
+constexpr std::uint64_t topDownToBottomUp = 14;
+constexpr std::uint64_t bottomUpToTopDown = 24;
+
+// Multiple of 64, so that bottom-up chunks never share a bitmap word.
+constexpr std::uint64_t nodeGrain = 4096;
+constexpr std::uint64_t frontierGrain = 256;
+
+class Bitmap {
+    std::vector<std::atomic<std::uint64_t>> words;
+
+public:
+    explicit Bitmap(std::uint64_t bits) : words((bits + 63) / 64) {}
+
+    bool test(std::uint64_t i) const {
+        return words[i >> 6].load(std::memory_order_relaxed) >> (i & 63) & 1;
+    }
+
+    // sets bit `i`, returns true if it was not set before
+    bool testAndSet(std::uint64_t i) {
+        std::uint64_t mask = std::uint64_t{1} << (i & 63);
+        return !(words[i >> 6].fetch_or(mask, std::memory_order_relaxed) & mask);
+    }
+
+    std::uint64_t word(std::uint64_t w) const {
+        return words[w].load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t numberOfWords() const {
+        return words.size();
+    }
+
+    void clear() {
+        for (auto &w : words) {
+            w.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Incoming edges of every node in compressed form, only needed for bottom-up steps on directed graphs.
+struct Transposed {
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> sources;
+
+    template <GraphLike G>
+    explicit Transposed(const G &graph) : offsets(graph.getNumberOfNodes() + 1, 0) {
+        for (std::uint64_t u = 0; u < graph.getNumberOfNodes(); ++u) {
+            graph.forEachNeighbor(u, [&](std::uint64_t v) {
+                ++offsets[v + 1];
+            });
+        }
+        for (std::uint64_t v = 0; v < graph.getNumberOfNodes(); ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        sources.resize(offsets.back());
+        std::vector<std::uint64_t> position(offsets.begin(), offsets.end() - 1);
+        for (std::uint64_t u = 0; u < graph.getNumberOfNodes(); ++u) {
+            graph.forEachNeighbor(u, [&](std::uint64_t v) {
+                sources[position[v]++] = u;
+            });
+        }
+    }
+};
+
+std::vector<std::uint64_t> concatenate(std::vector<std::vector<std::uint64_t>> &parts) {
+    std::uint64_t total = 0;
+    for (const auto &part : parts) {
+        total += part.size();
+    }
+    std::vector<std::uint64_t> result;
+    result.reserve(total);
+    for (auto &part : parts) {
+        result.insert(result.end(), part.begin(), part.end());
+        part.clear();
+    }
+    return result;
+}
+
+}  // namespace
+
+template <GraphLike G>
+BfsResult parallelBfs(const G &graph, const std::vector<std::uint64_t> &sources, unsigned threads) {
+    threads = resolveThreadCount(threads);
+    const std::uint64_t n = graph.getNumberOfNodes();
+
+    BfsResult result;
+    result.distance.assign(n, BfsResult::unreachable);
+    result.parent.assign(n, BfsResult::unreachable);
+
+    Bitmap visited(n);
+    std::vector<std::uint64_t> frontier;
+    std::uint64_t frontierEdges = 0;
+    for (auto s : sources) {
+        assert(s < n);
+        if (visited.testAndSet(s)) {
+            result.distance[s] = 0;
+            result.parent[s] = s;
+            frontier.push_back(s);
+            frontierEdges += graph.getDegree(s);
+        }
+    }
+    std::uint64_t unexploredEdges = graph.getNumberOfEdges() - frontierEdges;
+
+    std::unique_ptr<Transposed> transposed;
+    Bitmap current(n), next(n);
+    std::vector<std::vector<std::uint64_t>> localFrontiers(threads);
+    std::vector<std::uint64_t> localEdges(threads);
+
+    bool bottomUp = false;
+    std::uint64_t level = 0;
+    std::uint64_t reached = frontier.size();
+    std::uint64_t frontierSize = frontier.size();
+
+    while (frontierSize > 0) {
+        if (!bottomUp && frontierEdges > unexploredEdges / topDownToBottomUp) {
+            bottomUp = true;
+            if (graph.directed && !transposed) {
+                transposed = std::make_unique<Transposed>(graph);
+            }
+            current.clear();
+            for (auto v : frontier) {
+                current.testAndSet(v);
+            }
+        } else if (bottomUp && frontierSize < n / bottomUpToTopDown) {
+            bottomUp = false;
+            std::vector<std::vector<std::uint64_t>> words(threads);
+            parallelForChunks(0, current.numberOfWords(), threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+                for (std::uint64_t w = from; w < to; ++w) {
+                    for (std::uint64_t bits = current.word(w); bits; bits &= bits - 1) {
+                        words[t].push_back(w * 64 + std::countr_zero(bits));
+                    }
+                }
+            }, nodeGrain / 64);
+            frontier = concatenate(words);
+        }
+
+        std::fill(localEdges.begin(), localEdges.end(), 0);
+        if (bottomUp) {
+            next.clear();
+            std::vector<std::uint64_t> localFound(threads, 0);
+            parallelForChunks(0, n, threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+                for (std::uint64_t v = from; v < to; ++v) {
+                    if (visited.test(v)) {
+                        continue;
+                    }
+                    auto tryParent = [&](std::uint64_t u) {
+                        if (!current.test(u)) {
+                            return false;
+                        }
+                        result.parent[v] = u;
+                        result.distance[v] = level + 1;
+                        next.testAndSet(v);
+                        ++localFound[t];
+                        localEdges[t] += graph.getDegree(v);
+                        return true;
+                    };
+                    if (transposed) {
+                        for (auto i = transposed->offsets[v]; i < transposed->offsets[v + 1]; ++i) {
+                            if (tryParent(transposed->sources[i])) {
+                                break;
+                            }
+                        }
+                    } else {
+                        graph.forEachNeighbor(v, [&](std::uint64_t u) {
+                            return !tryParent(u);
+                        });
+                    }
+                }
+            }, nodeGrain);
+            // Nodes found in this step are marked only now, so that the scan above never sees a partial level.
+            frontierSize = 0;
+            parallelForChunks(0, next.numberOfWords(), threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+                for (std::uint64_t w = from; w < to; ++w) {
+                    for (std::uint64_t bits = next.word(w); bits; bits &= bits - 1) {
+                        visited.testAndSet(w * 64 + std::countr_zero(bits));
+                    }
+                }
+            }, nodeGrain / 64);
+            for (auto found : localFound) {
+                frontierSize += found;
+            }
+            std::swap(current, next);
+        } else {
+            parallelForChunks(0, frontier.size(), threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+                for (std::uint64_t i = from; i < to; ++i) {
+                    std::uint64_t u = frontier[i];
+                    graph.forEachNeighbor(u, [&](std::uint64_t v) {
+                        if (!visited.test(v) && visited.testAndSet(v)) {
+                            result.parent[v] = u;
+                            result.distance[v] = level + 1;
+                            localFrontiers[t].push_back(v);
+                            localEdges[t] += graph.getDegree(v);
+                        }
+                    });
+                }
+            }, frontierGrain);
+            frontier = concatenate(localFrontiers);
+            frontierSize = frontier.size();
+        }
+
+        frontierEdges = 0;
+        for (auto edges : localEdges) {
+            frontierEdges += edges;
+        }
+        unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+        reached += frontierSize;
+        if (frontierSize > 0) {
+            ++level;
+        }
+    }
+
+    result.depth = level;
+    result.reached = reached;
+    return result;
+}
+
+template <GraphLike G>
+BfsResult parallelBfs(const G &graph, std::uint64_t source, unsigned threads) {
+    return parallelBfs(graph, std::vector<std::uint64_t>{source}, threads);
+}
+
+#define TESTFRAME_INSTANTIATE_BFS(G) \
+    template BfsResult parallelBfs(const G &, const std::vector<std::uint64_t> &, unsigned); \
+    template BfsResult parallelBfs(const G &, std::uint64_t, unsigned);
+
+TESTFRAME_INSTANTIATE_BFS(Graph)
+TESTFRAME_INSTANTIATE_BFS(CsrGraph)
+TESTFRAME_INSTANTIATE_BFS(DynamicGraph)
+TESTFRAME_INSTANTIATE_BFS(ImplicitClique)
+TESTFRAME_INSTANTIATE_BFS(ImplicitPath)
+TESTFRAME_INSTANTIATE_BFS(ImplicitSilkworm)
+TESTFRAME_INSTANTIATE_BFS(ImplicitStarfish)
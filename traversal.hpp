@@ -0,0 +1,38 @@
+#ifndef TRAVERSAL_H_
+#define TRAVERSAL_H_
+
+#include "graph.hpp"
+#include <limits>
+
+struct BfsResult {
+    static constexpr std::uint64_t unreachable = std::numeric_limits<std::uint64_t>::max();
+
+    // number of edges on a shortest path from the nearest source, `unreachable` if there is no path
+    std::vector<std::uint64_t> distance;
+    // predecessor in the BFS tree, the node itself for sources and `unreachable` for nodes that were not reached
+    std::vector<std::uint64_t> parent;
+    // largest finite distance
+    std::uint64_t depth = 0;
+    // number of nodes with a finite distance
+    std::uint64_t reached = 0;
+};
+
+/**
+ * @brief Multi-threaded direction-optimizing BFS from all `sources` at once.
+ *
+ * Levels are expanded top-down (frontier pushes to its neighbours) while the frontier is small and bottom-up
+ * (unvisited nodes look for a parent in the frontier bitmap) once the frontier touches a large part of the remaining
+ * edges. Directed graphs are traversed along edge direction; their bottom-up steps use a transposed copy of the graph.
+ *
+ * Instantiated for `Graph`, `CsrGraph`, `DynamicGraph` and the implicit views of `implicit_graph.hpp`.
+ *
+ * @note Distances are deterministic, parents are any valid BFS parents and may differ between runs.
+ * @param threads number of worker threads, 0 uses all hardware threads
+ */
+template <GraphLike G>
+BfsResult parallelBfs(const G &graph, const std::vector<std::uint64_t> &sources, unsigned threads = 0);
+
+template <GraphLike G>
+BfsResult parallelBfs(const G &graph, std::uint64_t source, unsigned threads = 0);
+
+#endif
@@ -0,0 +1,149 @@
+#include "tree.hpp"
+#include "rand.hpp"
+#include <algorithm>
+#include <cassert>
+
+std::uint64_t Tree::getRoot() const {
+    return std::find(parent.begin(), parent.end(), noParent) - parent.begin();
+}
+
+Tree &Tree::relabelNodes() {
+    TESTFRAME_SCOPED_TIMER("Tree::relabelNodes");
+    auto perm = rnd.perm(getNumberOfNodes());
+    std::vector<std::uint64_t> relabeled(getNumberOfNodes());
+    for (std::uint64_t v = 0; v < getNumberOfNodes(); ++v) {
+        relabeled[perm[v]] = parent[v] == noParent ? noParent : perm[parent[v]];
+    }
+    parent = std::move(relabeled);
+    return *this;
+}
+
+CsrGraph Tree::toCsr() const {
+    TESTFRAME_SCOPED_TIMER("Tree::toCsr");
+    const std::uint64_t n = getNumberOfNodes();
+    std::vector<std::uint64_t> offsets(n + 1, 0);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (parent[v] != noParent) {
+            ++offsets[v + 1];
+            ++offsets[parent[v] + 1];
+        }
+    }
+    for (std::uint64_t v = 0; v < n; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    // offsets[v] doubles as the fill position of v and ends at the start of v + 1, shifting it back restores it.
+    std::vector<NodeId> targets(offsets.back());
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (parent[v] != noParent) {
+            targets[offsets[v]++] = parent[v];
+            targets[offsets[parent[v]]++] = v;
+        }
+    }
+    for (std::uint64_t v = n; v > 0; --v) {
+        offsets[v] = offsets[v - 1];
+    }
+    offsets[0] = 0;
+    return CsrGraph(std::move(offsets), std::move(targets));
+}
+
+Graph Tree::toGraph() const {
+    TESTFRAME_SCOPED_TIMER("Tree::toGraph");
+    const std::uint64_t n = getNumberOfNodes();
+    std::vector<std::uint64_t> degree(n, 0);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (parent[v] != noParent) {
+            ++degree[v];
+            ++degree[parent[v]];
+        }
+    }
+    std::vector<std::vector<NodeId>> g(n);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        g[v].reserve(degree[v]);
+    }
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (parent[v] != noParent) {
+            g[v].push_back(parent[v]);
+            g[parent[v]].push_back(v);
+        }
+    }
+    return Graph(std::move(g));
+}
+
+Tree Tree::constructRecursiveTree(std::uint64_t nodes, std::int64_t skew) {
+    TESTFRAME_SCOPED_TIMER("Tree::constructRecursiveTree");
+    assert(nodes > 0);
+    std::vector<std::uint64_t> parent(nodes);
+    parent[0] = noParent;
+    for (std::uint64_t v = 1; v < nodes; ++v) {
+        parent[v] = skew == 0 ? rnd.intFromRange(v - 1) : rnd.weightedNumFromRange(v, skew);
+    }
+    return Tree(std::move(parent)).relabelNodes();
+}
+
+Tree Tree::constructCaterpillarTree(std::uint64_t nodes, std::uint64_t spineLength) {
+    TESTFRAME_SCOPED_TIMER("Tree::constructCaterpillarTree");
+    assert(0 < spineLength && spineLength <= nodes);
+    std::vector<std::uint64_t> parent(nodes);
+    parent[0] = noParent;
+    for (std::uint64_t v = 1; v < spineLength; ++v) {
+        parent[v] = v - 1;
+    }
+    for (std::uint64_t v = spineLength; v < nodes; ++v) {
+        parent[v] = rnd.intFromRange(spineLength - 1);
+    }
+    return Tree(std::move(parent)).relabelNodes();
+}
+
+Tree Tree::constructKaryTree(std::uint64_t nodes, std::uint64_t k) {
+    TESTFRAME_SCOPED_TIMER("Tree::constructKaryTree");
+    assert(nodes > 0 && k > 0);
+    std::vector<std::uint64_t> parent(nodes);
+    parent[0] = noParent;
+    for (std::uint64_t v = 1; v < nodes; ++v) {
+        parent[v] = (v - 1) / k;
+    }
+    return Tree(std::move(parent)).relabelNodes();
+}
+
+Tree Tree::constructBoundedDegreeTree(std::uint64_t nodes, std::uint64_t maxChildren) {
+    TESTFRAME_SCOPED_TIMER("Tree::constructBoundedDegreeTree");
+    assert(nodes > 0 && (maxChildren > 0 || nodes == 1));
+    // Choosing n - 1 of the n * maxChildren child slots uniformly gives child counts with the distribution of a
+    // Galton-Watson tree with Binomial(maxChildren, p) offspring conditioned on n nodes.
+    std::vector<std::uint64_t> children(nodes, 0);
+    SortedSampler slots(rnd, nodes - 1, nodes * maxChildren);
+    while (slots.hasNext()) {
+        ++children[slots.next() / maxChildren];
+    }
+
+    // Cycle lemma: the steps children[i] - 1 sum to -1 and exactly one rotation, starting right after the first
+    // minimum of the prefix sums, is the preorder child sequence of a tree.
+    std::int64_t sum = 0, minimum = 0;
+    std::uint64_t start = 0;
+    for (std::uint64_t i = 0; i < nodes; ++i) {
+        sum += static_cast<std::int64_t>(children[i]) - 1;
+        if (sum < minimum) {
+            minimum = sum;
+            start = i + 1;
+        }
+    }
+    std::rotate(children.begin(), children.begin() + start % nodes, children.end());
+
+    // Preorder decoding, the stack holds the nodes that still wait for children.
+    std::vector<std::uint64_t> parent(nodes), waiting;
+    parent[0] = noParent;
+    if (children[0] > 0) {
+        waiting.push_back(0);
+    }
+    for (std::uint64_t v = 1; v < nodes; ++v) {
+        std::uint64_t p = waiting.back();
+        parent[v] = p;
+        if (--children[p] == 0) {
+            waiting.pop_back();
+        }
+        if (children[v] > 0) {
+            waiting.push_back(v);
+        }
+    }
+    return Tree(std::move(parent)).relabelNodes();
+}
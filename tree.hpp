@@ -0,0 +1,53 @@
+#ifndef TREE_H_
+#define TREE_H_
+
+#include "csr_graph.hpp"
+#include "graph.hpp"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Rooted tree stored as a parent array, one word per node instead of two adjacency entries per edge.
+ *
+ * All `construct*` methods run in O(n), relabel the nodes with a random permutation like the `Graph` generators do,
+ * and offer a different shape:
+ * - `constructRecursiveTree`: every node picks an earlier node as its parent, `skew` is the `type` of
+ *   `Random::weightedNumFromRange`; 0 gives the uniform random recursive tree with depth ~ e ln n, positive values
+ *   favour recent nodes and give deep trees, negative values favour early nodes and give shallow, bushy trees,
+ * - `constructCaterpillarTree`: a path of `spineLength` nodes with every other node hanging off a random spine node,
+ *   so the diameter is `spineLength` + 1 (or less when legs are missing at the ends),
+ * - `constructKaryTree`: complete `k`-ary tree in BFS order, depth ~ log_k n,
+ * - `constructBoundedDegreeTree`: uniformly random tree among all ordered trees in which every node has at most
+ *   `maxChildren` children in distinct positions (conditioned Galton–Watson tree with binomial offspring), so every
+ *   degree is at most `maxChildren` + 1 without biasing the shape.
+ */
+class Tree {
+public:
+    static constexpr std::uint64_t noParent = std::numeric_limits<std::uint64_t>::max();
+
+    // parent[v] is the parent of `v`, `noParent` for the root
+    std::vector<std::uint64_t> parent;
+
+    explicit Tree(std::vector<std::uint64_t> parent) : parent(std::move(parent)) {}
+
+    std::uint64_t getNumberOfNodes() const {
+        return parent.size();
+    }
+
+    std::uint64_t getRoot() const;
+
+    Tree &relabelNodes();
+
+    // Undirected adjacency in CSR form, built from the parent array with two flat allocations.
+    CsrGraph toCsr() const;
+    // Undirected adjacency lists, each allocated once with its exact size.
+    Graph toGraph() const;
+
+    static Tree constructRecursiveTree(std::uint64_t nodes, std::int64_t skew = 0);
+    static Tree constructCaterpillarTree(std::uint64_t nodes, std::uint64_t spineLength);
+    static Tree constructKaryTree(std::uint64_t nodes, std::uint64_t k);
+    static Tree constructBoundedDegreeTree(std::uint64_t nodes, std::uint64_t maxChildren);
+};
+
+#endif
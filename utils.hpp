@@ -1,6 +1,7 @@
 #ifndef UTILS_H_
 #define UTILS_H_
 
+#include "format.hpp"
 #include <filesystem>
 #include <map>
 #include <vector>
@@ -15,11 +16,24 @@ const std::map<std::string, std::string> dirs = {{"promptInputDirectory", "in"},
 
 template <typename F, typename S>
 std::ostream &operator<<(std::ostream &os, const std::pair<F, S> &p) {
-    return os << "(" << p.first << ", " << p.second << ")";
+    if constexpr (format::Integer<F> && format::Integer<S>) {
+        TextWriter out(os, 64);
+        out << '(' << p.first << ", " << p.second << ')';
+        return os;
+    } else {
+        return os << "(" << p.first << ", " << p.second << ")";
+    }
 }
 
 template <typename T>
 std::ostream &operator<<(std::ostream &os, const std::vector<T> &v) {
+    if constexpr (format::Integer<T>) {
+        // short vectors get a buffer of their own size
+        TextWriter out(os, std::min<std::size_t>(TextWriter::defaultCapacity, 24 * v.size() + 8));
+        out << '{';
+        out.appendJoined(v, ", ") << '}';
+        return os;
+    }
     os << "{";
     typename std::vector<T>::const_iterator it;
     for (it = v.begin(); it != v.end(); ++it) {
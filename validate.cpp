@@ -0,0 +1,201 @@
+#include "validate.hpp"
+#include "csr_graph.hpp"
+#include "dynamic_graph.hpp"
+#include "implicit_graph.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+std::uint64_t edgeHash(std::uint64_t from, std::uint64_t to, std::uint64_t salt) {
+    return mix(mix(from ^ salt) + to);
+}
+
+// Lock-free union-find, roots are always linked towards the smaller index.
+class ConcurrentUnionFind {
+    std::vector<std::atomic<std::uint64_t>> parent;
+
+public:
+    explicit ConcurrentUnionFind(std::uint64_t size) : parent(size) {
+        for (std::uint64_t i = 0; i < size; ++i) {
+            parent[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint64_t find(std::uint64_t v) {
+        while (true) {
+            std::uint64_t p = parent[v].load(std::memory_order_relaxed);
+            if (p == v) {
+                return v;
+            }
+            std::uint64_t grandparent = parent[p].load(std::memory_order_relaxed);
+            if (grandparent != p) {
+                parent[v].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+            }
+            v = grandparent;
+        }
+    }
+
+    void unite(std::uint64_t a, std::uint64_t b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            std::uint64_t expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+};
+
+struct LocalProperties {
+    bool hasSelfLoops = false;
+    bool hasMultiEdges = false;
+    std::uint64_t forwardHash[2] = {0, 0};
+    std::uint64_t backwardHash[2] = {0, 0};
+    std::vector<std::uint64_t> degreeHistogram;
+    std::vector<std::uint64_t> sorted;
+};
+
+template <GraphLike G>
+bool isDirectedAcyclic(const G &graph, std::vector<std::atomic<std::uint64_t>> &inDegree) {
+    std::vector<std::uint64_t> ready;
+    for (std::uint64_t v = 0; v < graph.getNumberOfNodes(); ++v) {
+        if (inDegree[v].load(std::memory_order_relaxed) == 0) {
+            ready.push_back(v);
+        }
+    }
+    std::uint64_t processed = 0;
+    while (!ready.empty()) {
+        std::uint64_t u = ready.back();
+        ready.pop_back();
+        ++processed;
+        graph.forEachNeighbor(u, [&](std::uint64_t v) {
+            if (inDegree[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                ready.push_back(v);
+            }
+        });
+    }
+    return processed == graph.getNumberOfNodes();
+}
+
+}  // namespace
+
+template <GraphLike G>
+GraphProperties computeGraphProperties(const G &graph, unsigned threads) {
+    threads = resolveThreadCount(threads);
+    const std::uint64_t n = graph.getNumberOfNodes();
+
+    // `components` joins the endpoints of every edge, `parity` joins u with v' and u' with v on a doubled node set,
+    // so the underlying graph is bipartite exactly when no v ends up together with its copy v'.
+    ConcurrentUnionFind components(n), parity(2 * n);
+    std::vector<std::atomic<std::uint64_t>> inDegree(graph.directed ? n : 0);
+    std::vector<LocalProperties> local(threads);
+
+    parallelForChunks(0, n, threads, [&](std::uint64_t from, std::uint64_t to, unsigned t) {
+        LocalProperties &mine = local[t];
+        for (std::uint64_t u = from; u < to; ++u) {
+            std::uint64_t degree = graph.getDegree(u);
+            if (mine.degreeHistogram.size() <= degree) {
+                mine.degreeHistogram.resize(degree + 1, 0);
+            }
+            ++mine.degreeHistogram[degree];
+
+            mine.sorted.clear();
+            graph.forEachNeighbor(u, [&](std::uint64_t v) {
+                mine.sorted.push_back(v);
+            });
+            std::sort(mine.sorted.begin(), mine.sorted.end());
+            for (std::uint64_t i = 0; i < mine.sorted.size(); ++i) {
+                std::uint64_t v = mine.sorted[i];
+                mine.hasSelfLoops |= v == u;
+                mine.hasMultiEdges |= i > 0 && mine.sorted[i - 1] == v;
+
+                for (int k = 0; k < 2; ++k) {
+                    mine.forwardHash[k] += edgeHash(u, v, k);
+                    mine.backwardHash[k] += edgeHash(v, u, k);
+                }
+                components.unite(u, v);
+                parity.unite(u, v + n);
+                parity.unite(u + n, v);
+                if (graph.directed) {
+                    inDegree[v].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+    }, 256);
+
+    GraphProperties properties;
+    properties.numberOfNodes = n;
+    std::uint64_t forwardHash[2] = {0, 0}, backwardHash[2] = {0, 0};
+    for (const auto &mine : local) {
+        properties.hasSelfLoops |= mine.hasSelfLoops;
+        properties.hasMultiEdges |= mine.hasMultiEdges;
+        for (int k = 0; k < 2; ++k) {
+            forwardHash[k] += mine.forwardHash[k];
+            backwardHash[k] += mine.backwardHash[k];
+        }
+        if (properties.degreeHistogram.size() < mine.degreeHistogram.size()) {
+            properties.degreeHistogram.resize(mine.degreeHistogram.size(), 0);
+        }
+        for (std::uint64_t d = 0; d < mine.degreeHistogram.size(); ++d) {
+            properties.degreeHistogram[d] += mine.degreeHistogram[d];
+        }
+    }
+    properties.isSimple = !properties.hasSelfLoops && !properties.hasMultiEdges;
+    properties.isSymmetric = forwardHash[0] == backwardHash[0] && forwardHash[1] == backwardHash[1];
+
+    bool minFound = false;
+    for (std::uint64_t d = 0; d < properties.degreeHistogram.size(); ++d) {
+        properties.numberOfEdges += d * properties.degreeHistogram[d];
+        if (properties.degreeHistogram[d] > 0) {
+            if (!minFound) {
+                properties.minDegree = d;
+                minFound = true;
+            }
+            properties.maxDegree = d;
+        }
+    }
+
+    std::vector<std::uint64_t> sizes(n, 0);
+    for (std::uint64_t v = 0; v < n; ++v) {
+        ++sizes[components.find(v)];
+        if (parity.find(v) == parity.find(v + n)) {
+            properties.isBipartite = false;
+        }
+    }
+    for (auto size : sizes) {
+        if (size > 0) {
+            properties.componentSizes.push_back(size);
+        }
+    }
+    std::sort(properties.componentSizes.rbegin(), properties.componentSizes.rend());
+
+    properties.isForest = !graph.directed && properties.isSimple && properties.isSymmetric &&
+                          properties.numberOfEdges / 2 + properties.getNumberOfComponents() == n;
+    properties.isTree = properties.isForest && properties.getNumberOfComponents() == 1;
+    properties.isAcyclic = graph.directed ? isDirectedAcyclic(graph, inDegree) : properties.isForest;
+    return properties;
+}
+
+template GraphProperties computeGraphProperties(const Graph &, unsigned);
+template GraphProperties computeGraphProperties(const CsrGraph &, unsigned);
+template GraphProperties computeGraphProperties(const DynamicGraph &, unsigned);
+template GraphProperties computeGraphProperties(const ImplicitClique &, unsigned);
+template GraphProperties computeGraphProperties(const ImplicitPath &, unsigned);
+template GraphProperties computeGraphProperties(const ImplicitSilkworm &, unsigned);
+template GraphProperties computeGraphProperties(const ImplicitStarfish &, unsigned);
@@ -0,0 +1,56 @@
+#ifndef VALIDATE_H_
+#define VALIDATE_H_
+
+#include "graph.hpp"
+
+/**
+ * @brief Structural properties of a graph, all gathered by one parallel pass over the adjacency lists
+ * (plus a linear topological sort for directed graphs).
+ *
+ * Components and bipartiteness always refer to the underlying undirected graph.
+ */
+struct GraphProperties {
+    std::uint64_t numberOfNodes = 0;
+    // number of adjacency entries, so every undirected edge is counted twice
+    std::uint64_t numberOfEdges = 0;
+
+    bool hasSelfLoops = false;
+    bool hasMultiEdges = false;
+    // no self-loops and no multi-edges
+    bool isSimple = true;
+    // every entry u -> v has a matching v -> u, with multiplicities
+    bool isSymmetric = true;
+    // directed graphs: no directed cycle, undirected graphs: same as `isForest`
+    bool isAcyclic = true;
+    // undirected, simple, symmetric and without cycles
+    bool isForest = false;
+    // forest with exactly one component
+    bool isTree = false;
+    bool isBipartite = true;
+
+    std::uint64_t minDegree = 0;
+    std::uint64_t maxDegree = 0;
+    // degreeHistogram[d] is the number of nodes with exactly d outgoing adjacency entries
+    std::vector<std::uint64_t> degreeHistogram;
+    // sizes of connected components, largest first
+    std::vector<std::uint64_t> componentSizes;
+
+    std::uint64_t getNumberOfComponents() const {
+        return componentSizes.size();
+    }
+};
+
+/**
+ * @brief Computes all `GraphProperties` of `graph` in a single fused pass, parallel across nodes.
+ *
+ * Symmetry is checked by comparing order-independent 128-bit hashes of the edge multisets { (u, v) } and { (v, u) },
+ * so an asymmetric graph is reported as symmetric with negligible probability.
+ *
+ * Instantiated for `Graph`, `CsrGraph`, `DynamicGraph` and the implicit views of `implicit_graph.hpp`.
+ *
+ * @param threads number of worker threads, 0 uses all hardware threads
+ */
+template <GraphLike G>
+GraphProperties computeGraphProperties(const G &graph, unsigned threads = 0);
+
+#endif
@@ -7,25 +7,26 @@
 #include <cmath>
 
 WeightedGraph& WeightedGraph::relabelNodes() {
-    auto perm = rnd.perm(getNumberOfNodes());
-    std::vector<std::uint64_t> inv_perm(getNumberOfNodes());
-    for (std::uint64_t i = 0; i < getNumberOfNodes(); i++) {
-        inv_perm[perm[i]] = i;
-    }
-    auto graph_copy = graph;
+    TESTFRAME_SCOPED_TIMER("WeightedGraph::relabelNodes");
+    auto perm = rnd.perm<NodeId>(getNumberOfNodes());
+    // Lists are moved to their new positions instead of copying the whole graph.
+    std::vector<std::vector<std::pair<NodeId, Weight>>> relabeled(getNumberOfNodes());
     for (std::uint64_t v = 0; v < getNumberOfNodes(); ++v) {
-        graph[v] = graph_copy[inv_perm[v]];
         for (auto& neigh : graph[v]) {
             neigh.first = perm[neigh.first];
         }
+        relabeled[perm[v]] = std::move(graph[v]);
     }
+    graph = std::move(relabeled);
     return *this;
 }
 
 WeightedGraph WeightedGraph::addRandomWeights(Graph g, std::int64_t w_min, std::int64_t w_max) {
-    std::vector<std::vector<std::pair<std::uint64_t, std::int64_t>>> graph(g.getNumberOfNodes());
+    TESTFRAME_SCOPED_TIMER("WeightedGraph::addRandomWeights");
+    assert(std::in_range<Weight>(w_min) && std::in_range<Weight>(w_max));
+    std::vector<std::vector<std::pair<NodeId, Weight>>> graph(g.getNumberOfNodes());
     for (auto [u, v] : g.getEdges()) {
-        std::int64_t w = rnd.intFromRange(w_min, w_max);
+        Weight w = rnd.intFromRange(w_min, w_max);
         if (!g.directed && u <= v) {
             graph[u].push_back({v, w});
             graph[v].push_back({u, w});
@@ -34,5 +35,5 @@ WeightedGraph WeightedGraph::addRandomWeights(Graph g, std::int64_t w_min, std::
             graph[u].push_back({v, w});
         }
     }
-    return WeightedGraph(graph).relabelNodes();
+    return WeightedGraph(std::move(graph)).relabelNodes();
 }
\ No newline at end of file
@@ -3,12 +3,17 @@
 
 #include "utils.hpp"
 #include "graph.hpp"
+#include "format.hpp"
+#include <cassert>
+#include <concepts>
+#include <limits>
 #include <numeric>
 #include <functional>
+#include <utility>
 
 class WeightedGraph {
 public: 
-    std::vector<std::vector<std::pair<std::uint64_t, std::int64_t>>> graph;
+    std::vector<std::vector<std::pair<NodeId, Weight>>> graph;
     enum class PrintFormat {
         PromptAdjecencyList,
         SolutionAdjecencyList,
@@ -23,90 +28,102 @@ public:
             Edge (uint64_t start, uint64_t end, uint64_t weight) : start(start), end(end), weight(weight) {}; 
     };
 private:
-    void printPromptAdjecencyListTo(std::ostream &outputStream) const {
-        outputStream << "{";
-        for (std::uint64_t i = 0; i < getNumberOfNodes(); ++i) {
-            outputStream << "{";
+    void printPromptAdjecencyListTo(std::ostream &outputStream, unsigned threads) const {
+        const std::uint64_t nodes = getNumberOfNodes();
+        outputStream << '{';
+        printInParallel(outputStream, nodes, threads, [&](std::uint64_t i) { return graph[i].size(); },
+                        [&](TextWriter &out, std::uint64_t i) {
+            out << '{';
             for (std::uint64_t j = 0; j < graph[i].size(); ++j) {
-                outputStream << "{" << graph[i][j].first << ", " << graph[i][j].second << "}";
+                out << '{' << graph[i][j].first << ", " << graph[i][j].second << '}';
                 if (j != graph[i].size() - 1) {
-                    outputStream << ",";
+                    out << ',';
                 }
             }
-            outputStream << "}";
-            if (i != getNumberOfNodes() - 1) {
-                outputStream << ",";
+            out << '}';
+            if (i != nodes - 1) {
+                out << ',';
             }
-        }
+        });
         outputStream << "}\n";
     }
 
-    void printSolutionAdjecencyListTo(std::ostream &outputStream) const {
-        auto edges = getEdges();
-
-        outputStream << getNumberOfNodes() << " " << edges.size() << "\n";
-        for (auto edge : edges) {
-            outputStream << edge.start << " " << edge.end << " " << edge.weight << "\n";
+    void printSolutionAdjecencyListTo(std::ostream &outputStream, unsigned threads) const {
+        {
+            TextWriter out(outputStream);
+            out << getNumberOfNodes() << ' ' << getNumberOfEdges() << '\n';
         }
+        printInParallel(outputStream, getNumberOfNodes(), threads, [&](std::uint64_t v) { return graph[v].size(); },
+                        [&](TextWriter &out, std::uint64_t v) {
+            for (auto [u, weight] : graph[v]) {
+                out << v << ' ' << u << ' ' << weight << '\n';
+            }
+        });
     }
 
-    void printSolutionAdjecencyMatrixTo(std::ostream &outputStream) const {
-        std::uint64_t nodes = getNumberOfNodes();
-        outputStream << nodes  << "\n";
-        
-        std::vector<std::vector<std::int64_t>> matrix(nodes, std::vector<std::int64_t>(nodes, 0));
-        for (auto [from, to, weight] : getEdges()) {
-            matrix[from][to] = weight;
-        }
-
-        for (std::uint64_t i = 0; i < nodes; ++i) {
-            for (std::uint64_t j = 0; j < nodes; ++j) {
-                outputStream << matrix[i][j];
-                if (j != nodes - 1) {
-                    outputStream << " ";
-                }
+    std::vector<std::vector<Weight>> getWeightMatrix() const {
+        std::vector<std::vector<Weight>> matrix(getNumberOfNodes(), std::vector<Weight>(getNumberOfNodes(), 0));
+        for (std::uint64_t v = 0; v < getNumberOfNodes(); ++v) {
+            for (auto [u, weight] : graph[v]) {
+                matrix[v][u] = weight;
             }
-            outputStream << "\n";
         }
+        return matrix;
     }
-    void printPromptAdjecencyMatrixTo(std::ostream &outputStream) const {
-        auto nodes = getNumberOfNodes();
 
-        std::vector<std::vector<std::int64_t>> matrix(nodes, std::vector<std::int64_t>(nodes, 0));
-
-        for (auto [from, to, weight] : getEdges()) {
-            matrix[from][to] = weight;
-        }
+    void printSolutionAdjecencyMatrixTo(std::ostream &outputStream, unsigned threads) const {
+        const std::uint64_t nodes = getNumberOfNodes();
+        const auto matrix = getWeightMatrix();
+        outputStream << nodes << '\n';
+        printInParallel(outputStream, nodes, threads, [&](std::uint64_t) { return nodes; },
+                        [&](TextWriter &out, std::uint64_t i) {
+            out.appendJoined(matrix[i], " ") << '\n';
+        });
+    }
 
-        outputStream << "{";
-        for (std::uint64_t i = 0; i < nodes; ++i) {
-            outputStream << "{";
-            for (std::uint64_t j = 0; j < nodes; ++j) {
-                outputStream << matrix[i][j];
-                if (j != nodes - 1) {
-                    outputStream << ",";
-                }
-            }
-            outputStream << "}";
+    void printPromptAdjecencyMatrixTo(std::ostream &outputStream, unsigned threads) const {
+        const std::uint64_t nodes = getNumberOfNodes();
+        const auto matrix = getWeightMatrix();
+        outputStream << '{';
+        printInParallel(outputStream, nodes, threads, [&](std::uint64_t) { return nodes; },
+                        [&](TextWriter &out, std::uint64_t i) {
+            out << '{';
+            out.appendJoined(matrix[i], ",");
+            out << '}';
             if (i != nodes - 1) {
-                outputStream << ",";
+                out << ',';
             }
-        }
+        });
         outputStream << "}\n";
     }
 public:
-    WeightedGraph(std::vector<std::vector<std::pair<std::uint64_t, std::int64_t>>> g) : graph(g) {}
+    WeightedGraph(std::vector<std::vector<std::pair<NodeId, Weight>>> g) : graph(std::move(g)) {}
+
+    // Converts lists of other id and weight types, every value has to fit in `NodeId` and `Weight`.
+    template <std::integral T, std::integral W>
+    requires (!std::same_as<std::pair<T, W>, std::pair<NodeId, Weight>>)
+    WeightedGraph(const std::vector<std::vector<std::pair<T, W>>> &g) : graph(g.size()) {
+        for (std::uint64_t v = 0; v < g.size(); ++v) {
+            graph[v].reserve(g[v].size());
+            for (auto [u, w] : g[v]) {
+                assert(static_cast<std::uint64_t>(u) <= std::numeric_limits<NodeId>::max());
+                assert(std::in_range<Weight>(w));
+                graph[v].emplace_back(static_cast<NodeId>(u), static_cast<Weight>(w));
+            }
+        }
+    }
 
     std::uint64_t getNumberOfNodes() const {
         return graph.size();
     }
 
     std::uint64_t getNumberOfEdges() const {
-        return std::accumulate(graph.begin(), graph.end(), 0,
+        return std::accumulate(graph.begin(), graph.end(), std::uint64_t{0},
                                [](const std::uint64_t x, const auto &a) { return x + a.size(); });
     }
 
     std::vector<Edge> getEdges() const {
+        TESTFRAME_SCOPED_TIMER("WeightedGraph::getEdges");
         std::vector<Edge> edges;
         for (std::uint64_t v = 0; v < getNumberOfNodes() ; ++v)
             for (auto u : graph[v]) {
@@ -115,34 +132,38 @@ public:
         return edges;
     }
 
-    void printTo(std::ostream &outputStream, PrintFormat format) const {
+    // `threads` format node ranges in parallel, the output does not depend on it.
+    void printTo(std::ostream &outputStream, PrintFormat format, unsigned threads = 1) const {
+        TESTFRAME_SCOPED_TIMER("WeightedGraph::printTo");
+        TESTFRAME_COUNT_BYTES_WRITTEN(outputStream);
         switch (format) {
             case PrintFormat::PromptAdjecencyList:
-                printPromptAdjecencyListTo(outputStream);
+                printPromptAdjecencyListTo(outputStream, threads);
                 break;
             case PrintFormat::SolutionAdjecencyList:
-                printSolutionAdjecencyListTo(outputStream);
+                printSolutionAdjecencyListTo(outputStream, threads);
                 break;
             case PrintFormat::SolutionAdjecencyMatrix:
-                printSolutionAdjecencyMatrixTo(outputStream);
+                printSolutionAdjecencyMatrixTo(outputStream, threads);
                 break;
             case PrintFormat::PromptAdjecencyMatrix:
-                printPromptAdjecencyMatrixTo(outputStream);
+                printPromptAdjecencyMatrixTo(outputStream, threads);
                 break;
         }
     }
 
     static WeightedGraph readWeightedGraph(std::istream &inputStream) {
+        TESTFRAME_SCOPED_TIMER("WeightedGraph::readWeightedGraph");
         std::uint64_t nodes, numberOfEdges;
         inputStream >> nodes >> numberOfEdges;
-        std::vector<std::vector<std::pair<std::uint64_t, std::int64_t>>> g(nodes);
+        std::vector<std::vector<std::pair<NodeId, Weight>>> g(nodes);
         for (std::uint64_t i = 0; i < numberOfEdges; i++) {
             std::uint64_t a, b;
             std::int64_t w;
             inputStream >> a >> b >> w;
-            g[a].push_back({b, w});
+            g[a].emplace_back(b, w);
         }
-        return WeightedGraph(g);
+        return WeightedGraph(std::move(g));
     }
 
     WeightedGraph &relabelNodes();
@@ -161,7 +182,11 @@ public:
     }
 
     operator std::vector<std::vector<std::pair<std::uint64_t, std::int64_t>>>() const {
-        return graph;
+        std::vector<std::vector<std::pair<std::uint64_t, std::int64_t>>> g(graph.size());
+        for (std::uint64_t v = 0; v < graph.size(); ++v) {
+            g[v].assign(graph[v].begin(), graph[v].end());
+        }
+        return g;
     }
 
     static WeightedGraph addRandomWeights(Graph g, std::int64_t w_min, std::int64_t w_max);
@@ -0,0 +1,85 @@
+#include "worst_case.hpp"
+#include "csr_graph.hpp"
+#include <deque>
+
+std::uint64_t countSpfaRelaxations(const WeightedGraph &graph, std::uint64_t source, std::uint64_t limit) {
+    TESTFRAME_SCOPED_TIMER("countSpfaRelaxations");
+    const std::uint64_t n = graph.getNumberOfNodes();
+    if (limit == 0) {
+        const std::uint64_t m = std::max<std::uint64_t>(1, graph.getNumberOfEdges());
+        limit = n > std::numeric_limits<std::uint64_t>::max() / m ? std::numeric_limits<std::uint64_t>::max() : n * m;
+    }
+    std::vector<std::int64_t> distance(n, std::numeric_limits<std::int64_t>::max());
+    std::vector<char> queued(n, false);
+    std::deque<NodeId> queue;
+    distance[source] = 0;
+    queue.push_back(static_cast<NodeId>(source));
+    queued[source] = true;
+    std::uint64_t relaxations = 0;
+    while (!queue.empty()) {
+        const NodeId v = queue.front();
+        queue.pop_front();
+        queued[v] = false;
+        for (auto [u, weight] : graph.graph[v]) {
+            if (distance[v] + weight < distance[u]) {
+                distance[u] = distance[v] + weight;
+                if (++relaxations == limit) {
+                    return relaxations;
+                }
+                if (!queued[u]) {
+                    queue.push_back(u);
+                    queued[u] = true;
+                }
+            }
+        }
+    }
+    return relaxations;
+}
+
+template <GraphLike G>
+std::uint64_t dfsRecursionDepth(const G &graph, std::uint64_t source) {
+    TESTFRAME_SCOPED_TIMER("dfsRecursionDepth");
+    // Every frame owns the neighbours of its node from `begin` in `pending`, `next` is the first one not tried yet.
+    struct Frame {
+        std::uint64_t begin;
+        std::uint64_t next;
+    };
+    std::vector<char> visited(graph.getNumberOfNodes(), false);
+    std::vector<NodeId> pending;
+    std::vector<Frame> stack;
+    auto enter = [&](std::uint64_t node) {
+        visited[node] = true;
+        stack.push_back({pending.size(), pending.size()});
+        graph.forEachNeighbor(node, [&](std::uint64_t u) { pending.push_back(static_cast<NodeId>(u)); });
+    };
+    enter(source);
+    std::uint64_t depth = 1;
+    while (!stack.empty()) {
+        Frame &frame = stack.back();
+        if (frame.next == pending.size()) {
+            pending.resize(frame.begin);
+            stack.pop_back();
+            continue;
+        }
+        const NodeId u = pending[frame.next++];
+        if (!visited[u]) {
+            enter(u);
+            depth = std::max<std::uint64_t>(depth, stack.size());
+        }
+    }
+    return depth;
+}
+
+template std::uint64_t dfsRecursionDepth(const Graph &, std::uint64_t);
+template std::uint64_t dfsRecursionDepth(const CsrGraph &, std::uint64_t);
+template std::uint64_t dfsRecursionDepth(const DynamicGraph &, std::uint64_t);
+
+void moveRandomEdge(DynamicGraph &graph, Random &random) {
+    assert(graph.getNumberOfNodes() >= 2 && graph.getNumberOfDistinctEdges() > 0);
+    const std::uint64_t n = graph.getNumberOfNodes();
+    auto [from, to] = graph.randomEdge(random);
+    graph.removeEdge(from, to);
+    // the removed edge may come back, so this ends even if the graph is complete
+    while (!graph.addEdge(random.intFromRange(n - 1), random.intFromRange(n - 1))) {
+    }
+}
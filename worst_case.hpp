@@ -0,0 +1,164 @@
+#ifndef WORST_CASE_H_
+#define WORST_CASE_H_
+
+#include "dynamic_graph.hpp"
+#include "graph_view.hpp"
+#include "instrument.hpp"
+#include "parallel.hpp"
+#include "rand.hpp"
+#include "weighted_graph.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Number of successful relaxations of queue-based Bellman-Ford (SPFA) from `source`, the usual cost measure
+ * when tuning tests against it.
+ *
+ * Nodes are processed in FIFO order and a node is queued again only if it is not in the queue already. The count stops
+ * at `limit`, which defaults to the Bellman-Ford bound `nodes * edges` and so also ends the search on negative cycles.
+ */
+std::uint64_t countSpfaRelaxations(const WeightedGraph &graph, std::uint64_t source, std::uint64_t limit = 0);
+
+/**
+ * @brief Largest recursion depth of a recursive DFS from `source` that visits neighbours in adjacency order, e.g. to
+ * push tests towards stack overflows. The source is at depth 1.
+ *
+ * Runs in O(n + m) with an explicit stack. Instantiated for `Graph`, `CsrGraph` and `DynamicGraph`.
+ */
+template <GraphLike G>
+std::uint64_t dfsRecursionDepth(const G &graph, std::uint64_t source);
+
+// Removes a random edge and inserts a new random one, the basic move of edge-level searches with `annealingSearch`.
+void moveRandomEdge(DynamicGraph &graph, Random &random = rnd);
+
+struct SearchOptions {
+    // candidate evaluations over all chains, rounded up to whole rounds
+    std::uint64_t evaluations = 10000;
+    // independent annealing chains, the result depends only on `chains` and `seed`, not on `threads`
+    unsigned chains = 8;
+    // 0 uses all hardware threads
+    unsigned threads = 0;
+    // steps of every chain between two synchronization points, after which the worse half of the chains continues
+    // from the best candidate found so far
+    std::uint64_t roundLength = 64;
+    // temperatures in units of the score, falling geometrically over the search
+    double initialTemperature = 1.0;
+    double finalTemperature = 1e-3;
+    Random::IntType seed = 137;
+};
+
+template <typename Candidate>
+struct SearchResult {
+    Candidate best;
+    double score;
+    std::uint64_t evaluations = 0;
+    std::uint64_t accepted = 0;
+};
+
+/**
+ * @brief Simulated annealing in process: maximizes `score(candidate)` over candidates reached from `initial` by
+ * `mutate(candidate)` and returns the worst-case test found.
+ *
+ * Candidates can be graphs (e.g. a `DynamicGraph` with `moveRandomEdge`), generator parameters and seeds, or anything
+ * else that is copyable. Every step copy-assigns the chain's current candidate into a proposal, which reuses its
+ * memory, mutates and scores it, and accepts it with the Metropolis rule. Chains run in parallel on `threads`
+ * threads, so both callbacks must be thread-safe; while they run, `rnd` is the chain's own generator, seeded from
+ * `options.seed` rather than from the caller's `rnd`, so mutations, generators and randomized scorers are reproducible
+ * and the chains draw independent streams.
+ *
+ * @code
+ * auto result = annealingSearch(DynamicGraph(Graph::constructRegularGraph(1000, 3)),
+ *                               [](DynamicGraph &g) { moveRandomEdge(g); },
+ *                               [](const DynamicGraph &g) { return double(dfsRecursionDepth(g, 0)); });
+ * @endcode
+ */
+template <typename Candidate, typename Mutate, typename Score>
+SearchResult<Candidate> annealingSearch(Candidate initial, Mutate &&mutate, Score &&score,
+                                        const SearchOptions &options = {}) {
+    TESTFRAME_SCOPED_TIMER("annealingSearch");
+    assert(options.chains > 0 && options.roundLength > 0);
+    struct Chain {
+        Random random;
+        Candidate current;
+        Candidate proposal;
+        double currentScore;
+        Candidate best;
+        double bestScore;
+        std::uint64_t accepted = 0;
+    };
+
+    Random seeds(options.seed);
+    const double initialScore = score(initial);
+    std::vector<Chain> chains;
+    chains.reserve(options.chains);
+    for (unsigned c = 0; c < options.chains; ++c) {
+        chains.push_back({Random(static_cast<Random::IntType>(seeds.engine())), initial, initial, initialScore,
+                          initial, initialScore});
+    }
+
+    const std::uint64_t stepsPerChain = (options.evaluations + options.chains - 1) / options.chains;
+    const std::uint64_t rounds = (stepsPerChain + options.roundLength - 1) / options.roundLength;
+    const std::uint64_t totalSteps = rounds * options.roundLength;
+    const double cooling = std::log(options.finalTemperature / options.initialTemperature);
+
+    SearchResult<Candidate> result{initial, initialScore};
+    for (std::uint64_t round = 0; round < rounds; ++round) {
+        parallelForChunks(0, chains.size(), options.threads, [&](std::uint64_t from, std::uint64_t to, unsigned) {
+            for (std::uint64_t c = from; c < to; ++c) {
+                Chain &chain = chains[c];
+                // the callbacks draw from `rnd`, which is the chain's generator for the duration of its steps
+                std::swap(rnd, chain.random);
+                for (std::uint64_t step = round * options.roundLength; step < (round + 1) * options.roundLength;
+                     ++step) {
+                    const double temperature =
+                        options.initialTemperature * std::exp(cooling * static_cast<double>(step) / totalSteps);
+                    chain.proposal = chain.current;
+                    mutate(chain.proposal);
+                    const double proposalScore = score(std::as_const(chain.proposal));
+                    if (proposalScore >= chain.currentScore ||
+                        rnd.doubleBetween01() < std::exp((proposalScore - chain.currentScore) / temperature)) {
+                        std::swap(chain.current, chain.proposal);
+                        chain.currentScore = proposalScore;
+                        ++chain.accepted;
+                        if (proposalScore > chain.bestScore) {
+                            chain.best = chain.current;
+                            chain.bestScore = proposalScore;
+                        }
+                    }
+                }
+                std::swap(rnd, chain.random);
+            }
+        }, 1);
+
+        // Ties go to the lower chain index, so the outcome does not depend on the thread schedule.
+        for (auto &chain : chains) {
+            if (chain.bestScore > result.score) {
+                result.best = chain.best;
+                result.score = chain.bestScore;
+            }
+        }
+        std::vector<std::uint64_t> order(chains.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::uint64_t a, std::uint64_t b) {
+            return chains[a].currentScore > chains[b].currentScore;
+        });
+        for (std::uint64_t i = (chains.size() + 1) / 2; i < chains.size(); ++i) {
+            chains[order[i]].current = result.best;
+            chains[order[i]].currentScore = result.score;
+        }
+    }
+
+    result.evaluations = rounds * options.roundLength * chains.size();
+    for (const auto &chain : chains) {
+        result.accepted += chain.accepted;
+    }
+    return result;
+}
+
+#endif